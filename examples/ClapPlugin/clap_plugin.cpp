@@ -107,7 +107,7 @@ bool ClapPlugin::guiSetParent(const clap_window* window) noexcept {
 
 #if __linux__
   if (_host.canUsePosixFdSupport() && app_->window()) {
-    int fd_flags = CLAP_POSIX_FD_READ | CLAP_POSIX_FD_WRITE | CLAP_POSIX_FD_ERROR;
+    int fd_flags = CLAP_POSIX_FD_READ | CLAP_POSIX_FD_ERROR;
     return _host.posixFdSupportRegister(app_->window()->posixFd(), fd_flags);
   }
 #endif
@@ -66,6 +66,7 @@ Overlay::Overlay() :
                visage::Animation<float>::kLinear) {
   animation_.setAnimationTime(160.0f);
   animation_.setTargetValue(1.0f);
+  addAnimation(animation_);
 }
 
 void Overlay::resized() { }
@@ -84,9 +85,6 @@ void Overlay::draw(visage::Canvas& canvas) {
   canvas.roundedRectangleBorder(body.x(), body.y(), body.width(), body.height(), rounding, 1.0f);
 
   on_animate_.callback(overlay_amount);
-
-  if (animation_.isAnimating())
-    redraw();
 }
 
 visage::Bounds Overlay::bodyBounds() const {
@@ -106,6 +104,8 @@ Showcase::Showcase() : palette_color_window_(&palette_), palette_value_window_(&
 
   palette_.initWithDefaults();
   setPalette(&palette_);
+  palette_.onColorChange() += [this](visage::theme::ColorId id) { redrawThemeDependents(id); };
+  palette_.onValueChange() += [this](visage::theme::ValueId id) { redrawThemeDependents(id); };
 
   blur_ = std::make_unique<visage::BlurPostEffect>();
   examples_ = std::make_unique<ExamplesFrame>();
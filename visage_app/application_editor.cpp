@@ -22,8 +22,10 @@
 #include "application_editor.h"
 
 #include "client_window_decoration.h"
+#include "frame_scheduler.h"
 #include "visage_graphics/canvas.h"
 #include "visage_graphics/renderer.h"
+#include "visage_ui/animation_manager.h"
 #include "visage_windowing/windowing.h"
 #include "window_event_handler.h"
 
@@ -59,7 +61,11 @@ namespace visage {
     canvas_->addRegion(top_level_.region());
     top_level_.addChild(this);
 
-    event_handler_.request_redraw = [this](Frame* frame) { stale_children_.insert(frame); };
+    event_handler_.request_redraw = [this](Frame* frame) {
+      if (stale_children_.empty() && window_)
+        window_->requestDraw();
+      stale_children_.insert(frame);
+    };
     event_handler_.request_keyboard_focus = [this](Frame* frame) {
       if (window_event_handler_)
         window_event_handler_->setKeyboardFocus(frame);
@@ -84,6 +90,7 @@ namespace visage {
   }
 
   ApplicationEditor::~ApplicationEditor() {
+    FrameScheduler::instance().removeEditor(this);
     top_level_.setEventHandler(nullptr);
   }
 
@@ -111,11 +118,10 @@ namespace visage {
 
     window_event_handler_ = std::make_unique<WindowEventHandler>(window, &top_level_);
 
-    window->setDrawCallback([this](double time) {
-      canvas_->updateTime(time);
-      EventManager::instance().checkEventTimers();
-      drawWindow();
-    });
+    EventManager::instance().setWakeupFunction(&wakeEventLoop);
+    FrameScheduler::instance().addEditor(this);
+    window->setDrawCallback([](double) { FrameScheduler::instance().tick(); });
+    window->setDrawDeadlineCallback([this] { return millisecondsUntilDraw(); });
 
     drawWindow();
     drawWindow();
@@ -132,16 +138,21 @@ namespace visage {
   }
 
   void ApplicationEditor::removeFromWindow() {
+    FrameScheduler::instance().removeEditor(this);
     window_event_handler_ = nullptr;
     window_ = nullptr;
     canvas_->removeFromWindow();
   }
 
-  void ApplicationEditor::drawWindow() {
+  bool ApplicationEditor::readyToDraw() const {
     if (window_ && !window_->isVisible())
-      return;
+      return false;
+
+    return width() && height();
+  }
 
-    if (width() == 0 || height() == 0)
+  void ApplicationEditor::drawWindow() {
+    if (!readyToDraw())
       return;
 
     if (!initialized())
@@ -151,6 +162,33 @@ namespace visage {
     canvas_->submit();
   }
 
+  int ApplicationEditor::submitDrawing(int submit_pass, double time) {
+    canvas_->updateTime(time);
+    if (!readyToDraw())
+      return submit_pass;
+
+    if (!initialized())
+      init();
+
+    drawStaleChildren();
+    return canvas_->submitLayers(submit_pass);
+  }
+
+  void ApplicationEditor::finishFrame() {
+    canvas_->finishFrame();
+  }
+
+  int ApplicationEditor::frameCount() const {
+    return canvas_->frameCount();
+  }
+
+  long long ApplicationEditor::millisecondsUntilDraw() const {
+    if (!stale_children_.empty() || AnimationManager::instance().isAnimating())
+      return 0;
+
+    return EventManager::instance().millisecondsUntilNextDeadline(time::milliseconds());
+  }
+
   void ApplicationEditor::drawStaleChildren() {
     drawing_children_.clear();
     std::swap(stale_children_, drawing_children_);
@@ -61,6 +61,11 @@ namespace visage {
     void setWindowless(int width, int height);
     void removeFromWindow();
     void drawWindow();
+    long long millisecondsUntilDraw() const;
+    bool readyToDraw() const;
+    int submitDrawing(int submit_pass, double time);
+    void finishFrame();
+    int frameCount() const;
 
     bool isFixedAspectRatio() const { return fixed_aspect_ratio_ > 0.0f; }
     void setFixedAspectRatio(float aspect_ratio) { fixed_aspect_ratio_ = aspect_ratio; }
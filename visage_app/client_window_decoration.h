@@ -33,6 +33,7 @@ namespace visage {
         hit_test_result_(hit_test_result), color_(kDefaultHoverColor) {
       hover_animation_.setSourceValue(0.0f);
       hover_animation_.setTargetValue(1.0f);
+      addAnimation(hover_animation_);
     }
 
     void mouseEnter(const MouseEvent& e) override {
@@ -48,9 +49,6 @@ namespace visage {
     void draw(Canvas& canvas) override {
       canvas.setColor(color_.withAlpha(color_.alpha() * hover_animation_.update()));
       canvas.fill(0, 0, width(), height());
-
-      if (hover_animation_.isAnimating())
-        redraw();
     }
 
     void setColor(const Color& color) { color_ = color; }
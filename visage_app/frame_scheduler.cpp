@@ -0,0 +1,85 @@
+/* Copyright Vital Audio, LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "frame_scheduler.h"
+
+#include "application_editor.h"
+#include "visage_ui/animation_manager.h"
+#include "visage_graphics/renderer.h"
+#include "visage_utils/time_utils.h"
+
+#include <algorithm>
+
+namespace visage {
+  FrameScheduler::FrameScheduler() {
+    start_microseconds_ = time::microseconds();
+    last_tick_microseconds_ = start_microseconds_ - frame_interval_microseconds_;
+  }
+
+  void FrameScheduler::addEditor(ApplicationEditor* editor) {
+    if (std::find(editors_.begin(), editors_.end(), editor) == editors_.end())
+      editors_.push_back(editor);
+  }
+
+  void FrameScheduler::removeEditor(ApplicationEditor* editor) {
+    editors_.erase(std::remove(editors_.begin(), editors_.end(), editor), editors_.end());
+  }
+
+  double FrameScheduler::time() const {
+    return (time::microseconds() - start_microseconds_) / 1000000.0;
+  }
+
+  void FrameScheduler::tick() {
+    long long current_microseconds = time::microseconds();
+    if (ticking_ || current_microseconds - last_tick_microseconds_ < frame_interval_microseconds_ / 2)
+      return;
+
+    ticking_ = true;
+    last_tick_microseconds_ = current_microseconds;
+    double time = (current_microseconds - start_microseconds_) / 1000000.0;
+    EventManager::instance().checkEventTimers();
+    AnimationManager::instance().advance(time);
+
+    submitted_.clear();
+    int submit_pass = 0;
+    bool first_frame = false;
+    for (int i = 0; i < editors_.size(); ++i) {
+      ApplicationEditor* editor = editors_[i];
+      int submission = editor->submitDrawing(submit_pass, time);
+      if (submission > submit_pass) {
+        submitted_.push_back(editor);
+        first_frame = first_frame || editor->frameCount() == 0;
+      }
+      submit_pass = submission;
+    }
+
+    if (!submitted_.empty()) {
+      Renderer::instance().submitFrame();
+      if (first_frame)
+        Renderer::instance().submitFrame();
+
+      for (ApplicationEditor* editor : submitted_)
+        editor->finishFrame();
+      frame_count_++;
+    }
+    ticking_ = false;
+  }
+}
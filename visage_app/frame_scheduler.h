@@ -0,0 +1,62 @@
+/* Copyright Vital Audio, LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <vector>
+
+namespace visage {
+  class ApplicationEditor;
+
+  // Draws every registered editor from a single clock so that all windows share one
+  // bgfx::frame() per refresh interval, regardless of how many windows are open.
+  class FrameScheduler {
+  public:
+    static constexpr long long kDefaultFrameIntervalMicroseconds = 16667;
+
+    static FrameScheduler& instance() {
+      static FrameScheduler instance;
+      return instance;
+    }
+
+    void addEditor(ApplicationEditor* editor);
+    void removeEditor(ApplicationEditor* editor);
+    int numEditors() const { return editors_.size(); }
+
+    void tick();
+    double time() const;
+    int frameCount() const { return frame_count_; }
+
+    void setFrameInterval(long long microseconds) { frame_interval_microseconds_ = microseconds; }
+    long long frameInterval() const { return frame_interval_microseconds_; }
+
+  private:
+    FrameScheduler();
+
+    std::vector<ApplicationEditor*> editors_;
+    std::vector<ApplicationEditor*> submitted_;
+    long long start_microseconds_ = 0;
+    long long last_tick_microseconds_ = 0;
+    long long frame_interval_microseconds_ = kDefaultFrameIntervalMicroseconds;
+    int frame_count_ = 0;
+    bool ticking_ = false;
+  };
+}
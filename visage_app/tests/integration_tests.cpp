@@ -107,4 +107,50 @@ TEST_CASE("Screenshot horizontal gradient", "[integration]") {
       REQUIRE(data[index + 3] == 0xff);
     }
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Frame scheduler submits one frame for all editors", "[integration]") {
+  ApplicationEditor editor1;
+  ApplicationEditor editor2;
+  int draws1 = 0;
+  int draws2 = 0;
+  editor1.onDraw() = [&](Canvas& canvas) {
+    draws1++;
+    canvas.setColor(0xff112233);
+    canvas.fill(0, 0, editor1.width(), editor1.height());
+  };
+  editor2.onDraw() = [&](Canvas& canvas) {
+    draws2++;
+    canvas.setColor(0xff445566);
+    canvas.fill(0, 0, editor2.width(), editor2.height());
+  };
+
+  editor1.setWindowless(10, 5);
+  editor2.setWindowless(10, 5);
+
+  FrameScheduler& scheduler = FrameScheduler::instance();
+  long long interval = scheduler.frameInterval();
+  scheduler.setFrameInterval(0);
+  scheduler.addEditor(&editor1);
+  scheduler.addEditor(&editor2);
+
+  editor1.redraw();
+  editor2.redraw();
+  int start_draws1 = draws1;
+  int start_draws2 = draws2;
+  int renderer_frames = Renderer::instance().frameCount();
+  int scheduler_frames = scheduler.frameCount();
+  scheduler.tick();
+  REQUIRE(draws1 == start_draws1 + 1);
+  REQUIRE(draws2 == start_draws2 + 1);
+  REQUIRE(Renderer::instance().frameCount() == renderer_frames + 1);
+  REQUIRE(scheduler.frameCount() == scheduler_frames + 1);
+
+  scheduler.tick();
+  REQUIRE(Renderer::instance().frameCount() == renderer_frames + 1);
+
+  scheduler.removeEditor(&editor1);
+  scheduler.removeEditor(&editor2);
+  scheduler.setFrameInterval(interval);
+  REQUIRE(scheduler.numEditors() == 0);
+}
@@ -30,13 +30,13 @@ namespace visage {
   WindowEventHandler::WindowEventHandler(Window* window, Frame* frame) :
       window_(window), content_frame_(frame) {
     window->setEventHandler(this);
-    content_frame_->onResize() += resize_callback_;
+    resize_callback_ = content_frame_->onResize().add([this] { onFrameResize(content_frame_); });
   }
 
   WindowEventHandler::~WindowEventHandler() {
     window_->clearEventHandler();
     if (content_frame_)
-      content_frame_->onResize() -= resize_callback_;
+      content_frame_->onResize().remove(resize_callback_);
   }
 
   void WindowEventHandler::onFrameResize(const Frame* frame) const {
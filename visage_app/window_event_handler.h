@@ -89,7 +89,7 @@ namespace visage {
     Frame* mouse_down_frame_ = nullptr;
     Frame* keyboard_focused_frame_ = nullptr;
     Frame* drag_drop_target_frame_ = nullptr;
-    std::function<void()> resize_callback_ = [this] { onFrameResize(content_frame_); };
+    CallbackToken resize_callback_;
 
     Point last_mouse_position_ = { 0, 0 };
     HitTestResult current_hit_test_ = HitTestResult::Client;
@@ -21,11 +21,113 @@
 
 #pragma once
 
+#include "visage_utils/events.h"
 #include "visage_utils/time_utils.h"
 
+#include <algorithm>
+
 namespace visage {
+  class AnimationProgress;
+
+  // Drives registered animations from a shared frame clock instead of each animation
+  // reading the system time.
+  class AnimationClock {
+  public:
+    virtual ~AnimationClock() = default;
+    virtual void startAnimating(AnimationProgress* animation) = 0;
+    virtual void removeAnimation(AnimationProgress* animation) = 0;
+  };
+
+  class AnimationProgress {
+  public:
+    AnimationProgress() = default;
+    explicit AnimationProgress(int milliseconds) : time_(milliseconds) { }
+    // Copies take the animation state but not the clock registration, which belongs to the owner
+    AnimationProgress(const AnimationProgress& other) { *this = other; }
+
+    AnimationProgress& operator=(const AnimationProgress& other) {
+      if (this == &other)
+        return *this;
+
+      targeting_ = other.targeting_;
+      t_ = other.t_;
+      time_ = other.time_;
+      last_ms_ = other.last_ms_;
+      if (clock_ && isAnimating())
+        clock_->startAnimating(this);
+      return *this;
+    }
+
+    virtual ~AnimationProgress() {
+      if (clock_)
+        clock_->removeAnimation(this);
+    }
+
+    // on_advance runs when the clock starts or steps this animation, e.g. to redraw what shows it.
+    void setClock(AnimationClock* clock, Delegate<void()> on_advance = nullptr) {
+      if (clock_)
+        clock_->removeAnimation(this);
+
+      clock_ = clock;
+      on_advance_ = std::move(on_advance);
+      if (clock_ && isAnimating())
+        clock_->startAnimating(this);
+    }
+
+    AnimationClock* clock() const { return clock_; }
+    void notifyAdvanced() const {
+      if (on_advance_)
+        on_advance_();
+    }
+
+    void target(bool target, bool jump = false) {
+      if (clock_ == nullptr)
+        last_ms_ = time::milliseconds();
+
+      targeting_ = target;
+      if (jump)
+        t_ = target ? 1.0f : 0.0f;
+
+      if (clock_ && isAnimating())
+        clock_->startAnimating(this);
+    }
+
+    bool isTargeting() const { return targeting_; }
+    bool isAnimating() const { return targeting_ ? t_ < 1.0f : t_ > 0.0f; }
+    void setAnimationTime(int milliseconds) { time_ = milliseconds; }
+    float progress() const { return t_; }
+
+    bool advance(double delta_ms) {
+      float delta = delta_ms / time_;
+      if (targeting_)
+        t_ = std::min(t_ + delta, 1.0f);
+      else
+        t_ = std::max(t_ - delta, 0.0f);
+      return isAnimating();
+    }
+
+  protected:
+    void updateProgress() {
+      if (clock_)
+        return;
+
+      long long ms = time::milliseconds();
+      advance(ms - last_ms_);
+      last_ms_ = ms;
+    }
+
+    bool targeting_ = false;
+    float t_ = 0.0f;
+
+  private:
+    AnimationClock* clock_ = nullptr;
+    Delegate<void()> on_advance_;
+    float time_ = 80.0f;
+    long long last_ms_ = 0;
+  };
+
   template<typename T>
-  class Animation {
+  class Animation : public AnimationProgress {
   public:
     enum EasingFunction {
       kLinear,
@@ -64,33 +166,23 @@ namespace visage {
 
     explicit Animation(int milliseconds, EasingFunction forward_easing = kLinear,
                        EasingFunction backward_easing = kLinear) :
-        source_(), target_(), time_(milliseconds), forward_easing_(forward_easing),
+        AnimationProgress(milliseconds), source_(), target_(), forward_easing_(forward_easing),
         backward_easing_(backward_easing) { }
 
     Animation(T* value, int milliseconds, EasingFunction forward_easing = kLinear,
               EasingFunction backward_easing = kLinear) :
-        value_(value), source_(), target_(), time_(milliseconds), forward_easing_(forward_easing),
-        backward_easing_(backward_easing) { }
+        AnimationProgress(milliseconds), value_(value), source_(), target_(),
+        forward_easing_(forward_easing), backward_easing_(backward_easing) { }
 
     Animation(T* value, T source, T target, int milliseconds,
               EasingFunction forward_easing = kLinear, EasingFunction backward_easing = kLinear) :
-        value_(value), source_(source), target_(target), time_(milliseconds),
+        AnimationProgress(milliseconds), value_(value), source_(source), target_(target),
         forward_easing_(forward_easing), backward_easing_(backward_easing) { }
 
-    void target(bool target, bool jump = false) {
-      last_ms_ = time::milliseconds();
-
-      targeting_ = target;
-      if (jump)
-        t_ = target ? 1.0f : 0.0f;
-    }
-    bool isTargeting() const { return targeting_; }
-    bool isAnimating() const { return targeting_ ? t_ < 1.0f : t_ > 0.0f; }
     void setSourceValue(T value) { source_ = value; }
     void setTargetValue(T value) { target_ = value; }
     T setSourceValue() const { return source_; }
     T setTargetValue() const { return target_; }
-    void setAnimationTime(int milliseconds) { time_ = milliseconds; }
 
     T value() const {
       float t = t_;
@@ -111,15 +203,7 @@ namespace visage {
     }
 
     T update() {
-      long long ms = time::milliseconds();
-      float delta = (ms - last_ms_) / time_;
-      last_ms_ = ms;
-
-      if (targeting_)
-        t_ = std::min(t_ + delta, 1.0f);
-      else
-        t_ = std::max(t_ - delta, 0.0f);
-
+      updateProgress();
       return value();
     }
 
@@ -127,13 +211,8 @@ namespace visage {
     T* value_ = nullptr;
     T source_;
     T target_;
-    float time_ = kRegularTime;
-    long long last_ms_ = 0;
 
     EasingFunction forward_easing_ = kLinear;
     EasingFunction backward_easing_ = kLinear;
-
-    bool targeting_ = false;
-    float t_ = 0.0f;
   };
 }
\ No newline at end of file
@@ -22,6 +22,7 @@
 #include "canvas.h"
 
 #include "palette.h"
+#include "renderer.h"
 #include "theme.h"
 
 #include <bgfx/bgfx.h>
@@ -60,29 +61,39 @@ namespace visage {
   }
 
   int Canvas::submit(int submit_pass) {
-    int submission = submit_pass;
-    for (int i = layers_.size() - 1; i > 0; --i)
-      submission = layers_[i]->submit(submission);
+    int submission = submitLayers(submit_pass);
 
     if (submission > submit_pass) {
-      composite_layer_.invalidate();
-      submission = composite_layer_.submit(submission);
-      bgfx::frame();
+      Renderer::instance().submitFrame();
       if (render_frame_ == 0)
-        bgfx::frame();
+        Renderer::instance().submitFrame();
 
-      render_frame_++;
-      FontCache::clearStaleFonts();
-      gradient_atlas_.clearStaleGradients();
-      image_atlas_.clearStaleImages();
+      finishFrame();
     }
     else if (last_skipped_frame_ != render_frame_) {
       last_skipped_frame_ = render_frame_;
-      bgfx::frame();
+      Renderer::instance().submitFrame();
     }
     return submission;
   }
 
+  int Canvas::submitLayers(int submit_pass) {
+    int submission = submit_pass;
+    for (int i = layers_.size() - 1; i > 0; --i)
+      submission = layers_[i]->submit(submission);
+
+    if (submission > submit_pass)
+      submission = composite_layer_.submit(submission);
+    return submission;
+  }
+
+  void Canvas::finishFrame() {
+    render_frame_++;
+    FontCache::clearStaleFonts();
+    gradient_atlas_.clearStaleGradients();
+    image_atlas_.clearStaleImages();
+  }
+
   void Canvas::requestScreenshot() {
     composite_layer_.requestScreenshot();
   }
@@ -125,27 +136,54 @@ namespace visage {
     addToPackedLayer(region, to);
   }
 
-  Brush Canvas::color(theme::ColorId color_id) {
-    if (palette_) {
-      Brush result;
-      theme::OverrideId last_check;
-      for (auto it = state_memory_.rbegin(); it != state_memory_.rend(); ++it) {
-        theme::OverrideId override_id = it->palette_override;
-        if (override_id.id != last_check.id && palette_->color(override_id, color_id, result))
-          return result;
-        last_check = override_id;
+  const Brush* Canvas::paletteColor(theme::ColorId color_id) {
+    if (theme_dependencies_)
+      theme_dependencies_->add(color_id);
+
+    if (palette_ == nullptr)
+      return nullptr;
+
+    theme::OverrideId last_check = state_.palette_override;
+    if (!last_check.isDefault()) {
+      if (const Brush* brush = palette_->findColor(last_check, color_id))
+        return brush;
+    }
+
+    for (auto it = state_memory_.rbegin(); it != state_memory_.rend(); ++it) {
+      theme::OverrideId override_id = it->palette_override;
+      if (override_id.id != last_check.id) {
+        if (const Brush* brush = palette_->findColor(override_id, color_id))
+          return brush;
       }
-      if (palette_->color({}, color_id, result))
-        return result;
+      last_check = override_id;
     }
+    return palette_->findColor({}, color_id);
+  }
+
+  void Canvas::setColor(theme::ColorId color_id) {
+    if (const Brush* brush = paletteColor(color_id))
+      setBrush(*brush);
+    else
+      setBrush(Brush::solid(theme::ColorId::defaultColor(color_id)));
+  }
+
+  Brush Canvas::color(theme::ColorId color_id) {
+    if (const Brush* brush = paletteColor(color_id))
+      return *brush;
 
     return Brush::solid(theme::ColorId::defaultColor(color_id));
   }
 
   float Canvas::value(theme::ValueId value_id) {
+    if (theme_dependencies_)
+      theme_dependencies_->add(value_id);
+
     if (palette_) {
       float result = 0.0f;
-      theme::OverrideId last_check;
+      theme::OverrideId last_check = state_.palette_override;
+      if (!last_check.isDefault() && palette_->value(last_check, value_id, result))
+        return result;
+
       for (auto it = state_memory_.rbegin(); it != state_memory_.rend(); ++it) {
         theme::OverrideId override_id = it->palette_override;
         if (override_id.id != last_check.id && palette_->value(override_id, value_id, result))
@@ -60,6 +60,8 @@ namespace visage {
 
     void clearDrawnShapes();
     int submit(int submit_pass = 0);
+    int submitLayers(int submit_pass);
+    void finishFrame();
 
     void requestScreenshot();
     const Screenshot& screenshot() const;
@@ -104,7 +106,7 @@ namespace visage {
     void setColor(const Brush& brush) { setBrush(brush); }
     void setColor(unsigned int color) { setBrush(Brush::solid(color)); }
     void setColor(const Color& color) { setBrush(Brush::solid(color)); }
-    void setColor(theme::ColorId color_id) { setBrush(color(color_id)); }
+    void setColor(theme::ColorId color_id);
 
     void setBlendedColor(theme::ColorId color_from, theme::ColorId color_to, float t) {
       setBrush(blendedColor(color_from, color_to, t));
@@ -481,6 +483,9 @@ namespace visage {
     void endRegion() { restoreState(); }
 
     void setPalette(Palette* palette) { palette_ = palette; }
+    void setThemeDependencies(theme::Dependencies* dependencies) {
+      theme_dependencies_ = dependencies;
+    }
     void setPaletteOverride(theme::OverrideId override_id) {
       state_.palette_override = override_id;
     }
@@ -518,6 +523,8 @@ namespace visage {
     State* state() { return &state_; }
 
   private:
+    const Brush* paletteColor(theme::ColorId color_id);
+
     template<typename T>
     constexpr float pixels(T&& value) {
       if constexpr (std::is_same_v<std::decay_t<T>, Dimension>)
@@ -732,6 +739,7 @@ namespace visage {
     }
 
     Palette* palette_ = nullptr;
+    theme::Dependencies* theme_dependencies_ = nullptr;
     float dpi_scale_ = 1.0f;
     double render_time_ = 0.0;
     double delta_time_ = 0.0;
@@ -25,89 +25,190 @@
 #include "visage_utils/thread_utils.h"
 
 #include <bgfx/bgfx.h>
+#include <bitset>
 #include <freetype/freetype.h>
-#include <set>
+#include <freetype/ftsizes.h>
+#include <map>
+#include <mutex>
 #include <vector>
 
 namespace visage {
 
+  // Bitmap of the characters a face maps to glyphs. Characters are split into pages of 256 and
+  // only pages with a covered character are stored.
+  class CharacterCoverage {
+  public:
+    static constexpr int kPageBits = 8;
+    static constexpr int kPageSize = 1 << kPageBits;
+    static constexpr char32_t kMaxCharacter = 0x10ffff;
+
+    void add(char32_t character) {
+      if (character > kMaxCharacter)
+        return;
+
+      if (page_lookup_.empty())
+        page_lookup_.assign((kMaxCharacter >> kPageBits) + 1, kNoPage);
+
+      uint16_t& page = page_lookup_[character >> kPageBits];
+      if (page == kNoPage) {
+        page = pages_.size();
+        pages_.emplace_back();
+      }
+      pages_[page].set(character & (kPageSize - 1));
+    }
+
+    bool contains(char32_t character) const {
+      if (character > kMaxCharacter || page_lookup_.empty())
+        return false;
+
+      uint16_t page = page_lookup_[character >> kPageBits];
+      return page != kNoPage && pages_[page].test(character & (kPageSize - 1));
+    }
+
+  private:
+    static constexpr uint16_t kNoPage = 0xffff;
+
+    std::vector<uint16_t> page_lookup_;
+    std::vector<std::bitset<kPageSize>> pages_;
+  };
+
   class FreeTypeLibrary {
   public:
+    struct SharedFace {
+      const unsigned char* data = nullptr;
+      FT_Face face = nullptr;
+      CharacterCoverage coverage;
+      int ref_count = 0;
+      std::mutex mutex;
+    };
+
     static FreeTypeLibrary& instance() {
       static FreeTypeLibrary instance;
       return instance;
     }
 
-    static FT_Face newMemoryFace(const unsigned char* data, int data_size) {
-      FT_Face face = nullptr;
-      FT_New_Memory_Face(instance().library_, data, data_size, 0, &face);
-      instance().faces_.insert(face);
-      return face;
+    static SharedFace* loadMemoryFace(const unsigned char* data, int data_size) {
+      FreeTypeLibrary& library = instance();
+      std::lock_guard<std::mutex> lock(library.mutex_);
+      std::unique_ptr<SharedFace>& shared_face = library.faces_[data];
+      if (shared_face == nullptr) {
+        shared_face = std::make_unique<SharedFace>();
+        shared_face->data = data;
+        FT_New_Memory_Face(library.library_, data, data_size, 0, &shared_face->face);
+        loadCoverage(shared_face.get());
+      }
+      shared_face->ref_count++;
+      return shared_face.get();
     }
 
-    static void doneFace(FT_Face face) {
-      VISAGE_ASSERT(instance().faces_.count(face));
-      if (instance().faces_.count(face) == 0)
+    static void returnFace(SharedFace* shared_face) {
+      FreeTypeLibrary& library = instance();
+      std::lock_guard<std::mutex> lock(library.mutex_);
+      auto found = library.faces_.find(shared_face->data);
+      VISAGE_ASSERT(found != library.faces_.end() && found->second.get() == shared_face);
+      if (found == library.faces_.end() || --shared_face->ref_count > 0)
         return;
 
-      FT_Done_Face(face);
-      instance().faces_.erase(face);
+      FT_Done_Face(shared_face->face);
+      library.faces_.erase(found);
     }
 
   private:
+    static void loadCoverage(SharedFace* shared_face) {
+      if (shared_face->face == nullptr)
+        return;
+
+      FT_UInt glyph_index = 0;
+      FT_ULong character = FT_Get_First_Char(shared_face->face, &glyph_index);
+      while (glyph_index) {
+        shared_face->coverage.add(character);
+        character = FT_Get_Next_Char(shared_face->face, character, &glyph_index);
+      }
+    }
+
     FreeTypeLibrary() { FT_Init_FreeType(&library_); }
     ~FreeTypeLibrary() {
-      for (FT_Face face : faces_)
-        FT_Done_Face(face);
+      for (auto& shared_face : faces_)
+        FT_Done_Face(shared_face.second->face);
       FT_Done_FreeType(library_);
     }
 
-    std::set<FT_Face> faces_;
+    std::map<const unsigned char*, std::unique_ptr<SharedFace>> faces_;
+    std::mutex mutex_;
     FT_Library library_ = nullptr;
   };
 
+  // Every size of a font shares one FT_Face and keeps its own FT_Size. Anything touching the
+  // face or its glyph slot holds the face's lock so sizes can be used from different threads.
   class TypeFace {
   public:
     TypeFace(const TypeFace&) = delete;
     TypeFace& operator=(const TypeFace&) = delete;
 
-    TypeFace(int size, const unsigned char* data, int data_size) {
-      face_ = FreeTypeLibrary::newMemoryFace(data, data_size);
-      FT_Set_Pixel_Sizes(face_, 0, std::max(0, size));
+    TypeFace(int size, const unsigned char* data, int data_size) :
+        shared_face_(FreeTypeLibrary::loadMemoryFace(data, data_size)) {
+      std::lock_guard<std::mutex> lock(shared_face_->mutex);
+      FT_New_Size(face(), &size_);
+      FT_Activate_Size(size_);
+      FT_Set_Pixel_Sizes(face(), 0, std::max(0, size));
     }
 
-    ~TypeFace() { FreeTypeLibrary::doneFace(face_); }
+    ~TypeFace() {
+      {
+        std::lock_guard<std::mutex> lock(shared_face_->mutex);
+        FT_Done_Size(size_);
+      }
+      FreeTypeLibrary::returnFace(shared_face_);
+    }
+
+    int numGlyphs() const { return face()->num_glyphs; }
+    std::string familyName() const { return face()->family_name; }
+    std::string styleName() const { return face()->style_name; }
 
-    int numGlyphs() const { return face_->num_glyphs; }
-    std::string familyName() const { return face_->family_name; }
-    std::string styleName() const { return face_->style_name; }
+    int glyphIndex(char32_t character) const {
+      std::lock_guard<std::mutex> lock(shared_face_->mutex);
+      return FT_Get_Char_Index(face(), character);
+    }
 
-    int glyphIndex(char32_t character) const { return FT_Get_Char_Index(face_, character); }
-    bool hasCharacter(char32_t character) const { return glyphIndex(character); }
-    int lineHeight() const { return face_->size->metrics.height >> 6; }
+    bool hasCharacter(char32_t character) const {
+      return shared_face_->coverage.contains(character);
+    }
+    int lineHeight() const { return size_->metrics.height >> 6; }
 
-    FT_GlyphSlot characterInfo(char32_t character) const {
-      FT_Load_Char(face_, character, 0);
-      return face_->glyph;
+    template<typename F>
+    void characterInfo(char32_t character, F&& callback) const {
+      loadCharacter(character, 0, std::forward<F>(callback));
     }
 
-    FT_GlyphSlot characterRasterData(char32_t character) const {
-      FT_Load_Char(face_, character, FT_LOAD_RENDER);
-      return face_->glyph;
+    template<typename F>
+    void characterRasterData(char32_t character, F&& callback) const {
+      loadCharacter(character, FT_LOAD_RENDER, std::forward<F>(callback));
     }
 
-    FT_Face face() const { return face_; }
+    FT_Face face() const { return shared_face_->face; }
 
   private:
-    FT_Face face_ = nullptr;
+    template<typename F>
+    void loadCharacter(char32_t character, FT_Int32 flags, F&& callback) const {
+      std::lock_guard<std::mutex> lock(shared_face_->mutex);
+      FT_Activate_Size(size_);
+      FT_Load_Char(face(), character, flags);
+      callback(face()->glyph);
+    }
+
+    FreeTypeLibrary::SharedFace* shared_face_ = nullptr;
+    FT_Size size_ = nullptr;
   };
 
   class PackedFont {
   public:
-    PackedFont(int size, const unsigned char* data, int data_size) : size_(size), data_(data) {
-      std::unique_ptr<TypeFace> face = std::make_unique<TypeFace>(size, data, data_size);
-      std::unique_ptr<PackedGlyph[]> glyphs = std::make_unique<PackedGlyph[]>(face->numGlyphs());
-      type_faces_.push_back(std::move(face));
+    PackedFont(int size, const unsigned char* data, int data_size,
+               const std::vector<EmbeddedFile>& fallbacks) : size_(size), data_(data) {
+      type_faces_.push_back(std::make_unique<TypeFace>(size, data, data_size));
+      for (const EmbeddedFile& fallback : fallbacks) {
+        const unsigned char* fallback_data = reinterpret_cast<const unsigned char*>(fallback.data);
+        type_faces_.push_back(std::make_unique<TypeFace>(size, fallback_data, fallback.size));
+      }
 
       packed_glyphs_['\n'] = Font::kNullPackedGlyph;
     }
@@ -141,13 +242,14 @@ namespace visage {
 
       std::unique_ptr<unsigned int[]> texture = std::make_unique<unsigned int[]>(size);
       if (packed_glyph->type_face) {
-        FT_GlyphSlot glyph = packed_glyph->type_face->characterRasterData(character);
-        for (int y = 0; y < packed_glyph->height; ++y) {
-          for (int x = 0; x < packed_glyph->width; ++x) {
-            int i = y * packed_glyph->width + x;
-            texture[i] = ((glyph->bitmap.buffer[y * packed_glyph->width + x]) << 24) + 0xffffff;
+        packed_glyph->type_face->characterRasterData(character, [&](FT_GlyphSlot glyph) {
+          for (int y = 0; y < packed_glyph->height; ++y) {
+            for (int x = 0; x < packed_glyph->width; ++x) {
+              int i = y * packed_glyph->width + x;
+              texture[i] = ((glyph->bitmap.buffer[y * packed_glyph->width + x]) << 24) + 0xffffff;
+            }
           }
-        }
+        });
       }
       else {
         EmojiRasterizer::instance().drawIntoBuffer(character, size_, packed_glyph->width,
@@ -162,12 +264,13 @@ namespace visage {
     PackedGlyph* packCharacterGlyph(PackedGlyph* packed_glyph, const TypeFace* type_face, char32_t character) {
       static constexpr float kAdvanceMult = 1.0f / (1 << 6);
 
-      FT_GlyphSlot glyph = type_face->characterInfo(character);
-      packed_glyph->width = glyph->bitmap.width;
-      packed_glyph->height = glyph->bitmap.rows;
-      packed_glyph->x_offset = glyph->bitmap_left;
-      packed_glyph->y_offset = glyph->bitmap_top;
-      packed_glyph->x_advance = glyph->advance.x * kAdvanceMult;
+      type_face->characterInfo(character, [packed_glyph](FT_GlyphSlot glyph) {
+        packed_glyph->width = glyph->bitmap.width;
+        packed_glyph->height = glyph->bitmap.rows;
+        packed_glyph->x_offset = glyph->bitmap_left;
+        packed_glyph->y_offset = glyph->bitmap_top;
+        packed_glyph->x_advance = glyph->advance.x * kAdvanceMult;
+      });
       packed_glyph->type_face = type_face;
 
       packGlyph(packed_glyph, character);
@@ -243,7 +346,8 @@ namespace visage {
     bgfx::TextureHandle texture_handle_ = { bgfx::kInvalidHandle };
   };
 
-  bool Font::hasNewLine(const char32_t* string, int length) {
+  template<typename T>
+  bool Font::hasNewLine(const T* string, int length) {
     for (int i = 0; i < length; ++i) {
       if (isNewLine(string[i]))
         return true;
@@ -279,7 +383,8 @@ namespace visage {
     dpi_scale_ = other.dpi_scale_;
     font_data_ = other.font_data_;
     data_size_ = other.data_size_;
-    packed_font_ = FontCache::loadPackedFont(native_size_, font_data_, data_size_);
+    fallbacks_ = other.fallbacks_;
+    packed_font_ = FontCache::loadPackedFont(native_size_, font_data_, data_size_, fallbacks_);
   }
 
   Font& Font::operator=(const Font& other) {
@@ -294,7 +399,8 @@ namespace visage {
     dpi_scale_ = other.dpi_scale_;
     font_data_ = other.font_data_;
     data_size_ = other.data_size_;
-    packed_font_ = FontCache::loadPackedFont(native_size_, font_data_, data_size_);
+    fallbacks_ = other.fallbacks_;
+    packed_font_ = FontCache::loadPackedFont(native_size_, font_data_, data_size_, fallbacks_);
     return *this;
   }
 
@@ -303,6 +409,16 @@ namespace visage {
       FontCache::returnPackedFont(packed_font_);
   }
 
+  Font Font::withFallbacks(std::vector<EmbeddedFile> fallbacks) const {
+    Font result(*this);
+    if (result.packed_font_)
+      FontCache::returnPackedFont(result.packed_font_);
+    result.fallbacks_ = std::move(fallbacks);
+    result.packed_font_ = FontCache::loadPackedFont(native_size_, font_data_, data_size_,
+                                                    result.fallbacks_);
+    return result;
+  }
+
   int Font::nativeWidthOverflowIndex(const char32_t* string, int string_length, float width,
                                      bool round, int character_override) const {
     float string_width = 0;
@@ -328,7 +444,40 @@ namespace visage {
     return string_length;
   }
 
-  float Font::nativeStringWidth(const char32_t* string, int length, int character_override) const {
+  template<typename T>
+  std::vector<double> Font::nativePrefixAdvances(const T* string, int length,
+                                                 int character_override) const {
+    std::vector<double> advances(std::max(0, length) + 1, 0.0);
+    double string_width = 0.0;
+    for (int i = 0; i < length; ++i) {
+      char32_t character = character_override ? character_override : string[i];
+      if (!isIgnored(character))
+        string_width += packed_font_->packedGlyph(character)->x_advance;
+      advances[i + 1] = string_width;
+    }
+
+    return advances;
+  }
+
+  int Font::prefixOverflowIndex(const std::vector<double>& advances, int start, int end,
+                                double width, bool round) {
+    // Finds the first character in [start, end) whose break point passes width
+    double limit = advances[start] + width;
+    int low = start;
+    int high = end;
+    while (low < high) {
+      int mid = low + (high - low) / 2;
+      double break_point = round ? 0.5 * (advances[mid] + advances[mid + 1]) : advances[mid + 1];
+      if (break_point > limit)
+        high = mid;
+      else
+        low = mid + 1;
+    }
+    return low;
+  }
+
+  template<typename T>
+  float Font::nativeStringWidth(const T* string, int length, int character_override) const {
     if (length <= 0)
       return 0.0f;
 
@@ -346,7 +495,8 @@ namespace visage {
     return width;
   }
 
-  void Font::setVertexPositions(FontAtlasQuad* quads, const char32_t* text, int length, float x,
+  template<typename T>
+  void Font::setVertexPositions(FontAtlasQuad* quads, const T* text, int length, float x,
                                 float y, float width, float height, Justification justification,
                                 int character_override) const {
     if (length <= 0)
@@ -380,12 +530,13 @@ namespace visage {
     }
   }
 
-  std::vector<int> Font::nativeLineBreaks(const char32_t* string, int length, float width) const {
+  template<typename T>
+  std::vector<int> Font::nativeLineBreaks(const T* string, int length, float width) const {
     std::vector<int> line_breaks;
+    std::vector<double> advances = nativePrefixAdvances(string, length);
     int break_index = 0;
     while (break_index < length) {
-      int overflow_index = nativeWidthOverflowIndex(string + break_index, length - break_index, width) +
-                           break_index;
+      int overflow_index = prefixOverflowIndex(advances, break_index, length, width);
       if (overflow_index == length && !hasNewLine(string + break_index, overflow_index - break_index))
         break;
 
@@ -411,7 +562,8 @@ namespace visage {
     return line_breaks;
   }
 
-  void Font::setMultiLineVertexPositions(FontAtlasQuad* quads, const char32_t* text, int length,
+  template<typename T>
+  void Font::setMultiLineVertexPositions(FontAtlasQuad* quads, const T* text, int length,
                                          float x, float y, float width, float height,
                                          Justification justification) const {
     int line_height = nativeLineHeight();
@@ -441,6 +593,22 @@ namespace visage {
     }
   }
 
+#define VISAGE_INSTANTIATE_FONT_LAYOUT(T)                                                      \
+  template bool Font::hasNewLine(const T*, int);                                               \
+  template float Font::nativeStringWidth(const T*, int, int) const;                            \
+  template std::vector<double> Font::nativePrefixAdvances(const T*, int, int) const;           \
+  template std::vector<int> Font::nativeLineBreaks(const T*, int, float) const;                \
+  template void Font::setVertexPositions(FontAtlasQuad*, const T*, int, float, float, float,   \
+                                         float, Justification, int) const;                     \
+  template void Font::setMultiLineVertexPositions(FontAtlasQuad*, const T*, int, float, float, \
+                                                  float, float, Justification) const;
+
+  VISAGE_INSTANTIATE_FONT_LAYOUT(unsigned char)
+  VISAGE_INSTANTIATE_FONT_LAYOUT(char16_t)
+  VISAGE_INSTANTIATE_FONT_LAYOUT(char32_t)
+
+#undef VISAGE_INSTANTIATE_FONT_LAYOUT
+
   int Font::nativeLineHeight() const {
     return packed_font_->lineHeight();
   }
@@ -473,16 +641,21 @@ namespace visage {
 
   FontCache::~FontCache() = default;
 
-  PackedFont* FontCache::createOrLoadPackedFont(int size, const char* font_data, int data_size) {
+  PackedFont* FontCache::createOrLoadPackedFont(int size, const char* font_data, int data_size,
+                                                const std::vector<EmbeddedFile>& fallbacks) {
     VISAGE_ASSERT(Thread::isMainThread());
 
     const unsigned char* data = reinterpret_cast<const unsigned char*>(font_data);
-    std::pair<int, unsigned const char*> font_info(size, data);
-    if (cache_.count(font_info) == 0)
-      cache_[font_info] = std::make_unique<PackedFont>(size, data, data_size);
+    std::pair<int, std::vector<const char*>> font_info(size, { font_data });
+    for (const EmbeddedFile& fallback : fallbacks)
+      font_info.second.push_back(fallback.data);
+
+    std::unique_ptr<PackedFont>& packed_font = cache_[font_info];
+    if (packed_font == nullptr)
+      packed_font = std::make_unique<PackedFont>(size, data, data_size, fallbacks);
 
-    ref_count_[cache_[font_info].get()]++;
-    return cache_[font_info].get();
+    ref_count_[packed_font.get()]++;
+    return packed_font.get();
   }
 
   void FontCache::decrementPackedFont(PackedFont* packed_font) {
@@ -494,12 +667,14 @@ namespace visage {
   }
 
   void FontCache::removeStaleFonts() {
-    for (auto it = ref_count_.begin(); it != ref_count_.end();) {
-      if (it->second)
+    for (auto it = cache_.begin(); it != cache_.end();) {
+      auto count = ref_count_.find(it->second.get());
+      if (count != ref_count_.end() && count->second)
         ++it;
       else {
-        cache_.erase({ it->first->size(), it->first->data() });
-        it = ref_count_.erase(it);
+        if (count != ref_count_.end())
+          ref_count_.erase(count);
+        it = cache_.erase(it);
       }
     }
     has_stale_fonts_ = false;
@@ -77,7 +77,10 @@ namespace visage {
     static bool isIgnored(char32_t character) {
       return character == '\r' || isVariationSelector(character);
     }
-    static bool hasNewLine(const char32_t* string, int length);
+    // Layout functions accept Latin-1, UCS-2 or UTF-32 characters so compact strings are laid out
+    // without widening them first
+    template<typename T>
+    static bool hasNewLine(const T* string, int length);
 
     Font() = default;
     Font(float size, const char* font_data, int data_size);
@@ -95,8 +98,18 @@ namespace visage {
       return dpi_scale_ ? dpi_scale_ : 1.0f;
     }
     Font withDpiScale(float dpi_scale) const {
-      return Font(size_, fontData(), dataSize(), dpi_scale);
+      return Font(size_, fontData(), dataSize(), dpi_scale).withFallbacks(fallbacks_);
     }
+    Font withSize(float size) const {
+      if (dpi_scale_ == 0.0f)
+        return Font(size, fontData(), dataSize()).withFallbacks(fallbacks_);
+      return Font(size, fontData(), dataSize(), dpi_scale_).withFallbacks(fallbacks_);
+    }
+
+    // Fonts searched in order for characters the main font is missing before falling back to
+    // the emoji rasterizer, e.g. CJK or symbol fonts.
+    Font withFallbacks(std::vector<EmbeddedFile> fallbacks) const;
+    const std::vector<EmbeddedFile>& fallbacks() const { return fallbacks_; }
 
     int widthOverflowIndex(const char32_t* string, int string_length, float width,
                            bool round = false, int character_override = 0) const {
@@ -106,7 +119,18 @@ namespace visage {
       return nativeLineBreaks(string, length, width * dpiScale());
     }
 
-    float stringWidth(const char32_t* string, int length, int character_override = 0) const {
+    std::vector<double> prefixAdvances(const char32_t* string, int length, int character_override = 0) const {
+      std::vector<double> advances = nativePrefixAdvances(string, length, character_override);
+      double scale = 1.0 / dpiScale();
+      for (double& advance : advances)
+        advance *= scale;
+      return advances;
+    }
+    static int prefixOverflowIndex(const std::vector<double>& advances, int start, int end,
+                                   double width, bool round = false);
+
+    template<typename T>
+    float stringWidth(const T* string, int length, int character_override = 0) const {
       return nativeStringWidth(string, length, character_override) / dpiScale();
     }
     float stringWidth(const std::u32string& string, int character_override = 0) const {
@@ -123,29 +147,39 @@ namespace visage {
     int dataSize() const { return data_size_; }
     const bgfx::TextureHandle& textureHandle() const;
 
-    void setVertexPositions(FontAtlasQuad* quads, const char32_t* string, int length, float x, float y,
+    template<typename T>
+    void setVertexPositions(FontAtlasQuad* quads, const T* string, int length, float x, float y,
                             float width, float height, Justification justification = Justification::kCenter,
                             int character_override = 0) const;
 
-    void setMultiLineVertexPositions(FontAtlasQuad* quads, const char32_t* string, int length,
+    template<typename T>
+    void setMultiLineVertexPositions(FontAtlasQuad* quads, const T* string, int length,
                                      float x, float y, float width, float height,
                                      Justification justification = Justification::kCenter) const;
 
     const PackedFont* packedFont() const { return packed_font_; }
 
   private:
+    // A single query stops at the overflow index, so it stays a plain scan. Callers that query
+    // the same run repeatedly should use prefixAdvances with prefixOverflowIndex.
     int nativeWidthOverflowIndex(const char32_t* string, int string_length, float width,
                                  bool round = false, int character_override = 0) const;
-    float nativeStringWidth(const char32_t* string, int length, int character_override = 0) const;
+    template<typename T>
+    float nativeStringWidth(const T* string, int length, int character_override = 0) const;
     int nativeLineHeight() const;
     float nativeCapitalHeight() const;
     float nativeLowerDipHeight() const;
-    std::vector<int> nativeLineBreaks(const char32_t* string, int length, float width) const;
+    template<typename T>
+    std::vector<double> nativePrefixAdvances(const T* string, int length,
+                                             int character_override = 0) const;
+    template<typename T>
+    std::vector<int> nativeLineBreaks(const T* string, int length, float width) const;
 
     float size_ = 0.0f;
     int native_size_ = 0;
     const char* font_data_ = nullptr;
     int data_size_ = 0;
+    std::vector<EmbeddedFile> fallbacks_;
     float dpi_scale_ = 0.0f;
     PackedFont* packed_font_ = nullptr;
   };
@@ -168,11 +202,12 @@ namespace visage {
     }
 
     static PackedFont* loadPackedFont(int size, const EmbeddedFile& font) {
-      return instance()->createOrLoadPackedFont(size, font.data, font.size);
+      return instance()->createOrLoadPackedFont(size, font.data, font.size, {});
     }
 
-    static PackedFont* loadPackedFont(int size, const char* font_data, int data_size) {
-      return instance()->createOrLoadPackedFont(size, font_data, data_size);
+    static PackedFont* loadPackedFont(int size, const char* font_data, int data_size,
+                                      const std::vector<EmbeddedFile>& fallbacks = {}) {
+      return instance()->createOrLoadPackedFont(size, font_data, data_size, fallbacks);
     }
 
     static void returnPackedFont(PackedFont* packed_font) {
@@ -181,11 +216,12 @@ namespace visage {
 
     FontCache();
 
-    PackedFont* createOrLoadPackedFont(int size, const char* font_data, int data_size);
+    PackedFont* createOrLoadPackedFont(int size, const char* font_data, int data_size,
+                                       const std::vector<EmbeddedFile>& fallbacks);
     void decrementPackedFont(PackedFont* packed_font);
     void removeStaleFonts();
 
-    std::map<std::pair<int, unsigned const char*>, std::unique_ptr<PackedFont>> cache_;
+    std::map<std::pair<int, std::vector<const char*>>, std::unique_ptr<PackedFont>> cache_;
     std::map<PackedFont*, int> ref_count_;
     bool has_stale_fonts_ = false;
   };
@@ -22,8 +22,11 @@
 #include "layer.h"
 
 #include "canvas.h"
+#include "embedded/shaders.h"
+#include "graphics_caches.h"
 #include "region.h"
 #include "renderer.h"
+#include "uniforms.h"
 
 #include <bgfx/bgfx.h>
 
@@ -31,6 +34,7 @@ namespace visage {
   struct FrameBufferData {
     bgfx::TextureHandle read_back_handle = BGFX_INVALID_HANDLE;
     bgfx::FrameBufferHandle handle = BGFX_INVALID_HANDLE;
+    bgfx::FrameBufferHandle back_buffer = BGFX_INVALID_HANDLE;
     bgfx::TextureFormat::Enum format = bgfx::TextureFormat::RGBA8;
   };
 
@@ -157,9 +161,11 @@ namespace visage {
     else
       frame_buffer_data_->format = bgfx::TextureFormat::RGBA8;
 
+    // Swap chain back buffers don't keep their contents between presents so windows draw into a
+    // persistent target and copy all of it to the back buffer each frame
     if (window_handle_) {
-      frame_buffer_data_->handle = bgfx::createFrameBuffer(window_handle_, width_, height_,
-                                                           frame_buffer_data_->format);
+      frame_buffer_data_->back_buffer = bgfx::createFrameBuffer(window_handle_, width_, height_,
+                                                                frame_buffer_data_->format);
     }
     else {
       bool read_back = (bgfx::getCaps()->supported & BGFX_CAPS_TEXTURE_BLIT) &&
@@ -169,11 +175,12 @@ namespace visage {
         frame_buffer_data_->read_back_handle = bgfx::createTexture2D(width_, height_, false, 1,
                                                                      bgfx::TextureFormat::RGBA8, flags);
       }
-      frame_buffer_data_->handle = bgfx::createFrameBuffer(width_, height_, frame_buffer_data_->format,
-                                                           kFrameBufferFlags);
     }
+    frame_buffer_data_->handle = bgfx::createFrameBuffer(width_, height_, frame_buffer_data_->format,
+                                                         kFrameBufferFlags);
 
     bottom_left_origin_ = bgfx::getCaps()->originBottomLeft;
+    invalidate();
   }
 
   void Layer::destroyFrameBuffer() const {
@@ -181,6 +188,10 @@ namespace visage {
       bgfx::destroy(frame_buffer_data_->handle);
       frame_buffer_data_->handle = BGFX_INVALID_HANDLE;
     }
+    if (bgfx::isValid(frame_buffer_data_->back_buffer)) {
+      bgfx::destroy(frame_buffer_data_->back_buffer);
+      frame_buffer_data_->back_buffer = BGFX_INVALID_HANDLE;
+    }
   }
 
   bgfx::FrameBufferHandle& Layer::frameBuffer() const {
@@ -217,24 +228,56 @@ namespace visage {
     moveToVector(invalid_rects, invalid_rect_pieces_);
   }
 
+  std::vector<IBounds> Layer::invalidRects() const {
+    std::vector<IBounds> invalid_rects;
+    for (const auto& region_invalid_rects : invalid_rects_) {
+      invalid_rects.insert(invalid_rects.end(), region_invalid_rects.second.begin(),
+                           region_invalid_rects.second.end());
+    }
+    return invalid_rects;
+  }
+
   void Layer::clearInvalidRectAreas(int submit_pass) {
     ShapeBatch<Fill> clear_batch(BlendMode::Opaque);
-    std::vector<IBounds> invalid_rects;
-    for (auto& region_invalid_rects : invalid_rects_) {
-      for (const IBounds& rect : region_invalid_rects.second) {
-        invalid_rects.push_back(rect);
-        float x = rect.x();
-        float y = rect.y();
-        float width = rect.width();
-        float height = rect.height();
-        clear_batch.addShape(Fill({ x, y, x + width, y + height }, clear_brush_.get(), x, y, width, height));
-      }
+    std::vector<IBounds> invalid_rects = invalidRects();
+    for (const IBounds& rect : invalid_rects) {
+      float x = rect.x();
+      float y = rect.y();
+      float width = rect.width();
+      float height = rect.height();
+      clear_batch.addShape(Fill({ x, y, x + width, y + height }, clear_brush_.get(), x, y, width, height));
     }
 
     PositionedBatch positioned_clear = { &clear_batch, &invalid_rects, 0, 0 };
     clear_batch.submit(*this, submit_pass, { positioned_clear });
   }
 
+  void Layer::submitBackBufferCopy(int submit_pass) {
+    bgfx::setViewMode(submit_pass, bgfx::ViewMode::Sequential);
+    bgfx::setViewRect(submit_pass, 0, 0, width_, height_);
+    bgfx::setViewFrameBuffer(submit_pass, frame_buffer_data_->back_buffer);
+
+    UvVertex* vertices = initQuadVertices<UvVertex>(1);
+    if (vertices == nullptr)
+      return;
+
+    vertices[0] = { -1.0f, 1.0f, 0.0f, 0.0f };
+    vertices[1] = { 1.0f, 1.0f, 1.0f, 0.0f };
+    vertices[2] = { -1.0f, -1.0f, 0.0f, 1.0f };
+    vertices[3] = { 1.0f, -1.0f, 1.0f, 1.0f };
+    if (bottom_left_origin_) {
+      for (int i = 0; i < kVerticesPerQuad; ++i)
+        vertices[i].v = 1.0f - vertices[i].v;
+    }
+
+    static const bgfx::UniformHandle texture_uniform = bgfx::createUniform(Uniforms::kTexture,
+                                                                           bgfx::UniformType::Sampler, 1);
+    setBlendMode(BlendMode::Opaque);
+    bgfx::setTexture(0, texture_uniform, bgfx::getTexture(frame_buffer_data_->handle));
+    bgfx::submit(submit_pass,
+                 ProgramCache::programHandle(shaders::vs_full_screen_texture, shaders::fs_sample));
+  }
+
   int Layer::submit(int submit_pass) {
     if (!anyInvalidRects())
       return submit_pass;
@@ -246,8 +289,7 @@ namespace visage {
     if (bgfx::isValid(frame_buffer_data_->handle))
       bgfx::setViewFrameBuffer(submit_pass, frame_buffer_data_->handle);
 
-    if (intermediate_layer_)
-      clearInvalidRectAreas(submit_pass);
+    clearInvalidRectAreas(submit_pass);
 
     std::vector<RegionPosition> region_positions;
     std::vector<RegionPosition> overlapping_regions;
@@ -311,6 +353,9 @@ namespace visage {
     }
 
     submit_pass = submit_pass + 1;
+    if (bgfx::isValid(frame_buffer_data_->back_buffer))
+      submitBackBufferCopy(submit_pass++);
+
     for (Region* region : regions_) {
       if (region->postEffect())
         submit_pass = region->postEffect()->preprocess(region, submit_pass);
@@ -359,6 +404,8 @@ namespace visage {
   void Layer::requestScreenshot() {
     if (headless_render_)
       screenshot_requested_ = true;
+    else if (bgfx::isValid(frame_buffer_data_->back_buffer))
+      bgfx::requestScreenShot(frame_buffer_data_->back_buffer, "screenshot.png");
     else
       bgfx::requestScreenShot(frameBuffer(), "screenshot.png");
   }
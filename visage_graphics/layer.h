@@ -32,8 +32,6 @@ namespace visage {
 
   class Layer {
   public:
-    static constexpr int kInvalidRectMemory = 2;
-
     explicit Layer(GradientAtlas* gradient_atlas);
     ~Layer();
 
@@ -80,6 +78,7 @@ namespace visage {
 
     void invalidateRectInRegion(IBounds rect, const Region* region);
     bool anyInvalidRects() const { return !invalid_rects_.empty(); }
+    std::vector<IBounds> invalidRects() const;
 
     void setDimensions(int width, int height) {
       if (width == width_ && height == height_)
@@ -129,6 +128,8 @@ namespace visage {
     }
 
   private:
+    void submitBackBufferCopy(int submit_pass);
+
     bool bottom_left_origin_ = false;
     bool hdr_ = false;
     int width_ = 0;
@@ -59,6 +59,7 @@ namespace visage {
     }
 
     sortColors();
+    tables_dirty_ = true;
   }
 
   void Palette::sortColors() {
@@ -93,6 +94,7 @@ namespace visage {
           mapped.second = color_movement[mapped.second];
       }
     }
+    tables_dirty_ = true;
   }
 
   std::map<std::string, std::vector<theme::ColorId>> Palette::colorIdList(theme::OverrideId override_id) {
@@ -109,7 +111,24 @@ namespace visage {
     return results;
   }
 
+  void Palette::notifyColorIndexChange(int index) {
+    if (on_color_change_.empty())
+      return;
+
+    std::vector<theme::ColorId> changed;
+    for (const auto& override_map : color_map_) {
+      for (const auto& color : override_map.second) {
+        if (color.second == index)
+          changed.push_back(color.first);
+      }
+    }
+
+    for (theme::ColorId color_id : changed)
+      on_color_change_.callback(color_id);
+  }
+
   void Palette::removeColor(int index) {
+    notifyColorIndexChange(index);
     colors_.erase(colors_.begin() + index);
 
     for (auto& override_map : color_map_) {
@@ -120,6 +139,87 @@ namespace visage {
           color.second--;
       }
     }
+    tables_dirty_ = true;
+  }
+
+  int Palette::colorEntry(theme::OverrideId override_id, theme::ColorId color_id) {
+    unsigned int num_overrides = theme::OverrideId::numOverrideIds();
+    unsigned int num_ids = theme::ColorId::numColorIds();
+    bool registered = override_id.id < num_overrides && color_id.id < num_ids;
+    bool in_tables = override_id.id < tables_.size() && color_id.id < table_colors_;
+    if (tables_dirty_ || (registered && !in_tables))
+      rebuildTables();
+
+    if (!registered) {
+      auto& override_map = color_map_[override_id];
+      auto index = override_map.insert({ color_id, kNotSetId }).first;
+      return index->second;
+    }
+
+    int& entry = tables_[override_id.id].colors[color_id.id];
+    if (entry == kNotQueriedId) {
+      color_map_[override_id][color_id] = kNotSetId;
+      entry = kNotSetId;
+    }
+    return entry;
+  }
+
+  float Palette::valueEntry(theme::OverrideId override_id, theme::ValueId value_id) {
+    unsigned int num_overrides = theme::OverrideId::numOverrideIds();
+    unsigned int num_ids = theme::ValueId::numValueIds();
+    bool registered = override_id.id < num_overrides && value_id.id < num_ids;
+    bool in_tables = override_id.id < tables_.size() && value_id.id < table_values_;
+    if (tables_dirty_ || (registered && !in_tables))
+      rebuildTables();
+
+    if (!registered) {
+      auto& override_map = value_map_[override_id];
+      auto value = override_map.insert({ value_id, kNotSetValue }).first;
+      return value->second;
+    }
+
+    float& entry = tables_[override_id.id].values[value_id.id];
+    if (entry == kNotQueriedValue) {
+      value_map_[override_id][value_id] = kNotSetValue;
+      entry = kNotSetValue;
+    }
+    return entry;
+  }
+
+  void Palette::rebuildTables() {
+    unsigned int num_overrides = theme::OverrideId::numOverrideIds();
+    table_colors_ = theme::ColorId::numColorIds();
+    table_values_ = theme::ValueId::numValueIds();
+
+    tables_.resize(num_overrides);
+    for (auto& table : tables_) {
+      table.colors.assign(table_colors_, kNotQueriedId);
+      table.values.assign(table_values_, kNotQueriedValue);
+    }
+
+    for (const auto& override_map : color_map_) {
+      if (override_map.first.id >= num_overrides)
+        continue;
+
+      std::vector<int>& colors = tables_[override_map.first.id].colors;
+      for (const auto& color : override_map.second) {
+        if (color.first.id < table_colors_)
+          colors[color.first.id] = color.second;
+      }
+    }
+
+    for (const auto& override_map : value_map_) {
+      if (override_map.first.id >= num_overrides)
+        continue;
+
+      std::vector<float>& values = tables_[override_map.first.id].values;
+      for (const auto& value : override_map.second) {
+        if (value.first.id < table_values_)
+          values[value.first.id] = value.second;
+      }
+    }
+
+    tables_dirty_ = false;
   }
 
   std::string Palette::encode() const {
@@ -159,6 +259,7 @@ namespace visage {
     std::map<std::string, theme::ValueId> value_name_map = theme::ValueId::nameIdMap();
 
     color_map_.clear();
+    tables_dirty_ = true;
     std::string override_name;
     std::getline(stream, override_name);
     while (!override_name.empty()) {
@@ -21,7 +21,9 @@
 
 #pragma once
 
-#include "color.h"
+#include "gradient.h"
+#include "theme.h"
+#include "visage_utils/events.h"
 
 #include <iosfwd>
 #include <map>
@@ -53,19 +55,27 @@ namespace visage {
     std::map<std::string, std::vector<theme::ColorId>> colorIdList(theme::OverrideId override_id);
     std::map<std::string, std::vector<theme::ValueId>> valueIdList(theme::OverrideId override_id);
 
+    // Called when an id's entry or the brush it maps to changes. Replacing the whole palette with
+    // clear, decode or initWithDefaults is not reported.
+    auto& onColorChange() { return on_color_change_; }
+    auto& onValueChange() { return on_value_change_; }
+
     void setEditColor(int index, const Brush& color) {
       VISAGE_ASSERT(index >= 0 && index < colors_.size());
       colors_[index] = color;
+      notifyColorIndexChange(index);
     }
 
     void setColorIndexFrom(int index, const Color& color) {
       VISAGE_ASSERT(index >= 0 && index < colors_.size());
       colors_[index].gradient().setColor(0, color);
+      notifyColorIndexChange(index);
     }
 
     void setColorIndexTo(int index, const Color& color) {
       VISAGE_ASSERT(index >= 0 && index < colors_.size());
       colors_[index].gradient().setColor(1, color);
+      notifyColorIndexChange(index);
     }
 
     void toggleColorIndexStyle(int index) {
@@ -82,34 +92,41 @@ namespace visage {
         colors_[index].gradient().setResolution(1);
         colors_[index].position().shape = GradientPosition::InterpolationShape::Solid;
       }
+      notifyColorIndexChange(index);
     }
 
-    bool color(theme::OverrideId override_id, theme::ColorId color_id, Brush& color) {
-      if (color_map_[override_id].count(color_id) == 0)
-        color_map_[override_id][color_id] = kNotSetId;
+    const Brush* findColor(theme::OverrideId override_id, theme::ColorId color_id) {
+      int index = colorEntry(override_id, color_id);
+      if (index == kNotSetId)
+        return nullptr;
+      if (index < 0 || index >= colors_.size())
+        return &invalid_brush_;
+      return &colors_[index];
+    }
 
-      if (color_map_[override_id][color_id] == kNotSetId)
+    bool color(theme::OverrideId override_id, theme::ColorId color_id, Brush& color) {
+      const Brush* brush = findColor(override_id, color_id);
+      if (brush == nullptr)
         return false;
 
-      if (color_map_[override_id][color_id] == kInvalidId)
-        color = Brush::solid(kInvalidColor);
-      else
-        color = colors_[color_map_[override_id][color_id]];
+      color = *brush;
       return true;
     }
 
     void setColorMap(theme::OverrideId override_id, theme::ColorId color_id, int index) {
       color_map_[override_id][color_id] = index;
+      tables_dirty_ = true;
+      on_color_change_.callback(color_id);
     }
 
     void setColor(theme::OverrideId override_id, theme::ColorId color_id, const Color& color) {
       int index = addColor(color);
-      color_map_[override_id][color_id] = index;
+      setColorMap(override_id, color_id, index);
     }
 
     void setColor(theme::OverrideId override_id, theme::ColorId color_id, const Brush& color) {
       int index = addBrush(color);
-      color_map_[override_id][color_id] = index;
+      setColorMap(override_id, color_id, index);
     }
 
     void setColor(theme::ColorId color_id, const Color& color) { setColor({}, color_id, color); }
@@ -117,27 +134,37 @@ namespace visage {
 
     void setValue(theme::OverrideId override_id, theme::ValueId value_id, float value) {
       value_map_[override_id][value_id] = value;
+      tables_dirty_ = true;
+      on_value_change_.callback(value_id);
     }
 
     void setValue(theme::ValueId value_id, float value) { setValue({}, value_id, value); }
 
     void removeValue(theme::OverrideId override_id, theme::ValueId value_id) {
-      if (value_map_[override_id].count(value_id))
-        value_map_[override_id].erase(value_id);
+      auto map = value_map_.find(override_id);
+      if (map != value_map_.end() && map->second.erase(value_id)) {
+        tables_dirty_ = true;
+        on_value_change_.callback(value_id);
+      }
     }
 
     void removeValue(theme::ValueId value_id) { removeValue({}, value_id); }
 
-    int colorMap(theme::OverrideId override_id, theme::ColorId color_id) {
-      return color_map_[override_id][color_id];
+    int colorMap(theme::OverrideId override_id, theme::ColorId color_id) const {
+      auto map = color_map_.find(override_id);
+      if (map == color_map_.end())
+        return kNotSetId;
+      auto index = map->second.find(color_id);
+      return index == map->second.end() ? kNotSetId : index->second;
     }
 
     bool value(theme::OverrideId override_id, theme::ValueId value_id, float& result) {
-      if (value_map_[override_id].count(value_id) == 0)
-        value_map_[override_id][value_id] = kNotSetValue;
+      float value = valueEntry(override_id, value_id);
+      if (value == kNotSetValue)
+        return false;
 
-      result = value_map_[override_id][value_id];
-      return result != kNotSetValue;
+      result = value;
+      return true;
     }
 
     int addColor(const Color& color = 0xffff00ff) {
@@ -154,6 +181,7 @@ namespace visage {
       color_map_.clear();
       value_map_.clear();
       colors_.clear();
+      tables_dirty_ = true;
     }
 
     void removeColor(int index);
@@ -162,8 +190,33 @@ namespace visage {
     void decode(const std::string& data);
 
   private:
+    static constexpr int kNotQueriedId = -3;
+    static constexpr float kNotQueriedValue = -99998.0f;
+
+    // Dense copies of the maps indexed by id so lookups while drawing skip the tree searches.
+    // Entries nobody has asked for yet are still added to the maps on first lookup so the
+    // id lists show everything that has been drawn.
+    struct LookupTable {
+      std::vector<int> colors;
+      std::vector<float> values;
+    };
+
+    int colorEntry(theme::OverrideId override_id, theme::ColorId color_id);
+    float valueEntry(theme::OverrideId override_id, theme::ValueId value_id);
+    void rebuildTables();
+    void notifyColorIndexChange(int index);
+
     std::vector<Brush> colors_;
     std::map<theme::OverrideId, std::map<theme::ColorId, int>> color_map_;
     std::map<theme::OverrideId, std::map<theme::ValueId, float>> value_map_;
+
+    std::vector<LookupTable> tables_;
+    unsigned int table_colors_ = 0;
+    unsigned int table_values_ = 0;
+    bool tables_dirty_ = true;
+    Brush invalid_brush_ = Brush::solid(kInvalidColor);
+
+    CallbackList<void(theme::ColorId)> on_color_change_;
+    CallbackList<void(theme::ValueId)> on_value_change_;
   };
 }
\ No newline at end of file
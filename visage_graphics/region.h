@@ -79,6 +79,20 @@ namespace visage {
       invalidate();
     }
 
+    void setPosition(int x, int y) {
+      if (x == x_ && y == y_)
+        return;
+
+      invalidateInParent();
+      x_ = x;
+      y_ = y;
+      if (intermediate_region_) {
+        intermediate_region_->x_ = x;
+        intermediate_region_->y_ = y;
+      }
+      invalidateInParent();
+    }
+
     void setVisible(bool visible) { visible_ = visible; }
     bool isVisible() const { return visible_; }
     bool overlaps(const Region* other) const {
@@ -98,6 +112,13 @@ namespace visage {
         invalidateRect({ 0, 0, width_, height_ });
     }
 
+    void invalidateInParent() {
+      if (parent_ == nullptr)
+        invalidate();
+      else if (width_ > 0 && height_ > 0)
+        parent_->invalidateRect({ x_, y_, width_, height_ });
+    }
+
     Layer* layer() const;
 
     void clear() {
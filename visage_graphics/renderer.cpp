@@ -144,6 +144,11 @@ namespace visage {
     swap_chain_supported_ = bgfx::getCaps()->supported & BGFX_CAPS_SWAP_CHAIN;
   }
 
+  void Renderer::submitFrame() {
+    bgfx::frame();
+    frame_count_++;
+  }
+
   void Renderer::setScreenshotData(const uint8_t* data, int width, int height, int pitch, bool blue_red) {
     screenshot_ = Screenshot(data, width, height, pitch, blue_red);
   }
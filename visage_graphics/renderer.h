@@ -35,6 +35,8 @@ namespace visage {
     ~Renderer() override;
 
     void checkInitialization(void* model_window, void* display);
+    void submitFrame();
+    int frameCount() const { return frame_count_; }
     void setScreenshotData(const uint8_t* data, int width, int height, int pitch, bool blue_red);
     const Screenshot& screenshot() const { return screenshot_; }
 
@@ -51,6 +53,7 @@ namespace visage {
     bool initialized_ = false;
     bool supported_ = false;
     bool swap_chain_supported_ = false;
+    int frame_count_ = 0;
 
     Screenshot screenshot_;
     std::string error_message_;
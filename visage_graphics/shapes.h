@@ -535,19 +535,21 @@ namespace visage {
       quads = VectorPool<FontAtlasQuad>::instance().vector(text->text().length());
       this->clamp = clamp.clamp(x, y, width, height);
 
-      const char32_t* c_str = text->text().c_str();
-      int length = text->text().length();
       float w = width;
       float h = height;
       if (direction == Direction::Left || direction == Direction::Right)
         std::swap(w, h);
-      if (text->multiLine()) {
-        font.setMultiLineVertexPositions(quads.data(), c_str, length, 0, 0, w, h, text->justification());
-      }
-      else {
-        font.setVertexPositions(quads.data(), c_str, length, 0, 0, w, h, text->justification(),
-                                text->characterOverride());
-      }
+      text->text().visitCharacters([&](auto* characters, size_t size) {
+        int length = size;
+        if (text->multiLine()) {
+          font.setMultiLineVertexPositions(quads.data(), characters, length, 0, 0, w, h,
+                                           text->justification());
+        }
+        else {
+          font.setVertexPositions(quads.data(), characters, length, 0, 0, w, h,
+                                  text->justification(), text->characterOverride());
+        }
+      });
 
       if (direction == Direction::Down) {
         for (auto& quad : quads) {
@@ -0,0 +1,149 @@
+/* Copyright Vital Audio, LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "embedded/fonts.h"
+#include "visage_graphics/font.h"
+#include "visage_utils/string_utils.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <random>
+
+using namespace visage;
+
+namespace {
+  std::u32string randomWords(int length) {
+    std::mt19937 random(1);
+    std::u32string result;
+    result.reserve(length);
+    while (result.size() < static_cast<size_t>(length)) {
+      int word_length = 1 + random() % 10;
+      for (int i = 0; i < word_length; ++i)
+        result.push_back(U'a' + random() % 26);
+      result.push_back(random() % 20 ? U' ' : U'\n');
+    }
+    result.resize(length);
+    return result;
+  }
+}
+
+TEST_CASE("Prefix advances match string widths", "[graphics]") {
+  Font font(12, fonts::Lato_Regular_ttf, 1.0f);
+  std::u32string text = randomWords(1000);
+  std::vector<double> advances = font.prefixAdvances(text.c_str(), text.size());
+  REQUIRE(advances.size() == text.size() + 1);
+
+  int length = text.size();
+  for (int i = 0; i < length; i += 37) {
+    float width = font.stringWidth(text.c_str(), i);
+    REQUIRE(std::abs(advances[i] - width) < 0.01);
+
+    int overflow = Font::prefixOverflowIndex(advances, 0, length, width + 0.01);
+    REQUIRE(overflow >= i);
+    REQUIRE((overflow == length || advances[overflow + 1] > width));
+  }
+}
+
+TEST_CASE("Font sizes sharing a face measure independently", "[graphics]") {
+  std::u32string text = U"The quick brown fox";
+  std::u32string other_text = U"jumps over";
+  Font small(17, fonts::Lato_Regular_ttf, 1.0f);
+  Font large(51, fonts::Lato_Regular_ttf, 1.0f);
+
+  float small_width = small.stringWidth(text.c_str(), text.size());
+  float large_width = large.stringWidth(text.c_str(), text.size());
+  REQUIRE(large_width > 2.5f * small_width);
+  REQUIRE(large_width < 3.5f * small_width);
+  REQUIRE(large.lineHeight() > 2 * small.lineHeight());
+
+  float large_other_width = large.stringWidth(other_text.c_str(), other_text.size());
+  float small_other_width = small.stringWidth(other_text.c_str(), other_text.size());
+  REQUIRE(large_other_width > 2.5f * small_other_width);
+  REQUIRE(large_other_width < 3.5f * small_other_width);
+}
+
+TEST_CASE("Compact strings lay out like UTF-32", "[graphics]") {
+  Font font(14, fonts::Lato_Regular_ttf, 1.0f);
+  std::u32string utf32 = randomWords(200) + U"\u00E9";
+  String compact = utf32;
+  auto character_size = [](auto* characters, size_t) { return sizeof(*characters); };
+  REQUIRE(compact.visitCharacters(character_size) == 1);
+
+  int length = utf32.size();
+  std::vector<FontAtlasQuad> expected(length);
+  std::vector<FontAtlasQuad> quads(length);
+  font.setMultiLineVertexPositions(expected.data(), utf32.c_str(), length, 0, 0, 150, 400);
+  compact.visitCharacters([&](auto* characters, size_t size) {
+    REQUIRE(font.stringWidth(characters, size) == font.stringWidth(utf32));
+    font.setMultiLineVertexPositions(quads.data(), characters, size, 0, 0, 150, 400);
+  });
+
+  for (int i = 0; i < length; ++i) {
+    REQUIRE(quads[i].packed_glyph == expected[i].packed_glyph);
+    REQUIRE(quads[i].x == expected[i].x);
+    REQUIRE(quads[i].y == expected[i].y);
+  }
+}
+
+TEST_CASE("Line break 1MB of text", "[graphics][.benchmark]") {
+  Font font(12, fonts::Lato_Regular_ttf, 1.0f);
+  std::u32string text = randomWords(1 << 20);
+
+  BENCHMARK("Line breaks at 100px") {
+    return font.lineBreaks(text.c_str(), text.size(), 100.0f).size();
+  };
+
+  BENCHMARK("Line breaks at 500px") {
+    return font.lineBreaks(text.c_str(), text.size(), 500.0f).size();
+  };
+
+  BENCHMARK("Line breaks at 2000px") {
+    return font.lineBreaks(text.c_str(), text.size(), 2000.0f).size();
+  };
+}
+
+TEST_CASE("Font fallbacks cover missing characters", "[graphics]") {
+  std::u32string cyrillic = U"ддд";
+  Font mono(19, fonts::DroidSansMono_ttf, 1.0f);
+  Font lato(19, fonts::Lato_Regular_ttf, 1.0f);
+  Font with_fallback = lato.withFallbacks({ fonts::DroidSansMono_ttf });
+  REQUIRE(with_fallback.fallbacks().size() == 1);
+  REQUIRE(with_fallback.packedFont() != lato.packedFont());
+
+  float mono_width = mono.stringWidth(cyrillic);
+  REQUIRE(mono_width > 0.0f);
+  REQUIRE(with_fallback.stringWidth(cyrillic) == mono_width);
+  REQUIRE(lato.stringWidth(cyrillic) != mono_width);
+
+  std::u32string latin = U"Fallback";
+  REQUIRE(with_fallback.stringWidth(latin) == lato.stringWidth(latin));
+
+  Font scaled = with_fallback.withDpiScale(2.0f);
+  REQUIRE(scaled.fallbacks().size() == 1);
+  REQUIRE(scaled.stringWidth(cyrillic) == mono.withDpiScale(2.0f).stringWidth(cyrillic));
+
+  Font resized = with_fallback.withSize(28);
+  REQUIRE(resized.size() == 28);
+  REQUIRE(resized.dpiScale() == 1.0f);
+  REQUIRE(resized.fallbacks().size() == 1);
+  REQUIRE(resized.stringWidth(cyrillic) == mono.withSize(28).stringWidth(cyrillic));
+}
@@ -0,0 +1,81 @@
+/* Copyright Vital Audio, LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "visage_graphics/layer.h"
+#include "visage_graphics/region.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace visage;
+
+namespace {
+  int totalArea(const std::vector<IBounds>& rects) {
+    int area = 0;
+    for (const IBounds& rect : rects)
+      area += rect.width() * rect.height();
+    return area;
+  }
+
+  bool anyOverlapping(const std::vector<IBounds>& rects) {
+    for (int i = 0; i < rects.size(); ++i) {
+      for (int j = i + 1; j < rects.size(); ++j) {
+        if (rects[i].overlaps(rects[j]))
+          return true;
+      }
+    }
+    return false;
+  }
+}
+
+TEST_CASE("Layer redraws only the invalidated rects", "[graphics]") {
+  GradientAtlas gradient_atlas;
+  Layer layer(&gradient_atlas);
+  layer.setDimensions(100, 50);
+
+  Region left;
+  Region right;
+  left.setBounds(0, 0, 50, 50);
+  right.setBounds(50, 0, 50, 50);
+  layer.addRegion(&left);
+  layer.addRegion(&right);
+  REQUIRE_FALSE(layer.anyInvalidRects());
+
+  layer.invalidateRectInRegion({ 10, 10, 20, 20 }, &right);
+  std::vector<IBounds> rects = layer.invalidRects();
+  REQUIRE(rects.size() == 1);
+  REQUIRE(rects[0] == IBounds(60, 10, 20, 20));
+
+  layer.invalidateRectInRegion({ 15, 15, 5, 5 }, &right);
+  REQUIRE(layer.invalidRects().size() == 1);
+
+  layer.invalidateRectInRegion({ 20, 20, 40, 40 }, &right);
+  rects = layer.invalidRects();
+  REQUIRE_FALSE(anyOverlapping(rects));
+  REQUIRE(totalArea(rects) == 20 * 20 + 30 * 30 - 10 * 10);
+  for (const IBounds& rect : rects)
+    REQUIRE(rect.intersection({ 50, 0, 50, 50 }) == rect);
+
+  layer.invalidate();
+  rects = layer.invalidRects();
+  REQUIRE(rects.size() == 2);
+  REQUIRE_FALSE(anyOverlapping(rects));
+  REQUIRE(totalArea(rects) == 100 * 50);
+}
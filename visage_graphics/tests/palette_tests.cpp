@@ -0,0 +1,128 @@
+/* Copyright Vital Audio, LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "visage_graphics/palette.h"
+#include "visage_graphics/theme.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+
+using namespace visage;
+
+namespace {
+  VISAGE_THEME_COLOR(PaletteTestColor, 0xff112233);
+  VISAGE_THEME_COLOR(PaletteTestOtherColor, 0xff445566);
+  VISAGE_THEME_VALUE(PaletteTestValue, 3.0f);
+  VISAGE_THEME_PALETTE_OVERRIDE(PaletteTestOverride);
+}
+
+TEST_CASE("Palette lookups", "[graphics]") {
+  Palette palette;
+  REQUIRE(palette.findColor({}, PaletteTestColor) == nullptr);
+  float value = 0.0f;
+  REQUIRE_FALSE(palette.value({}, PaletteTestValue, value));
+
+  palette.setColor(PaletteTestColor, Color(0xffff0000));
+  palette.setValue(PaletteTestValue, 5.0f);
+  const Brush* brush = palette.findColor({}, PaletteTestColor);
+  REQUIRE(brush != nullptr);
+  REQUIRE(brush->gradient().sample(0.0f).toARGB() == 0xffff0000);
+  REQUIRE(palette.value({}, PaletteTestValue, value));
+  REQUIRE(value == 5.0f);
+
+  REQUIRE(palette.findColor(PaletteTestOverride, PaletteTestColor) == nullptr);
+  palette.setColor(PaletteTestOverride, PaletteTestColor, Color(0xff00ff00));
+  brush = palette.findColor(PaletteTestOverride, PaletteTestColor);
+  REQUIRE(brush != nullptr);
+  REQUIRE(brush->gradient().sample(0.0f).toARGB() == 0xff00ff00);
+
+  palette.setColorMap({}, PaletteTestColor, Palette::kInvalidId);
+  brush = palette.findColor({}, PaletteTestColor);
+  REQUIRE(brush != nullptr);
+  REQUIRE(brush->gradient().sample(0.0f).toARGB() == Palette::kInvalidColor);
+
+  palette.removeValue(PaletteTestValue);
+  REQUIRE_FALSE(palette.value({}, PaletteTestValue, value));
+
+  palette.clear();
+  REQUIRE(palette.findColor({}, PaletteTestColor) == nullptr);
+  REQUIRE(palette.findColor(PaletteTestOverride, PaletteTestColor) == nullptr);
+}
+
+TEST_CASE("Palette lists queried ids", "[graphics]") {
+  Palette palette;
+  REQUIRE(palette.colorIdList(PaletteTestOverride).empty());
+
+  palette.findColor(PaletteTestOverride, PaletteTestOtherColor);
+  float value = 0.0f;
+  palette.value(PaletteTestOverride, PaletteTestValue, value);
+
+  auto color_ids = palette.colorIdList(PaletteTestOverride);
+  REQUIRE(color_ids.size() == 1);
+  REQUIRE(color_ids.begin()->second.size() == 1);
+  REQUIRE(color_ids.begin()->second[0] == PaletteTestOtherColor);
+  REQUIRE(palette.valueIdList(PaletteTestOverride).size() == 1);
+  REQUIRE(palette.colorMap(PaletteTestOverride, PaletteTestOtherColor) == Palette::kNotSetId);
+}
+
+TEST_CASE("Palette change notifications", "[graphics]") {
+  Palette palette;
+  int index = palette.addColor(0xff000000);
+  palette.setColorMap({}, PaletteTestColor, index);
+  palette.setColorMap(PaletteTestOverride, PaletteTestOtherColor, index);
+
+  std::vector<theme::ColorId> changed_colors;
+  std::vector<theme::ValueId> changed_values;
+  palette.onColorChange() += [&](theme::ColorId color_id) { changed_colors.push_back(color_id); };
+  palette.onValueChange() += [&](theme::ValueId value_id) { changed_values.push_back(value_id); };
+
+  palette.setColorIndexFrom(index, Color(0xffffffff));
+  REQUIRE(changed_colors.size() == 2);
+  REQUIRE(std::count(changed_colors.begin(), changed_colors.end(), PaletteTestColor) == 1);
+  REQUIRE(std::count(changed_colors.begin(), changed_colors.end(), PaletteTestOtherColor) == 1);
+
+  changed_colors.clear();
+  palette.setColor(PaletteTestColor, Color(0xff00ff00));
+  REQUIRE(changed_colors.size() == 1);
+  REQUIRE(changed_colors[0] == PaletteTestColor);
+
+  palette.setValue(PaletteTestValue, 2.0f);
+  palette.removeValue(PaletteTestValue);
+  palette.removeValue(PaletteTestValue);
+  REQUIRE(changed_values.size() == 2);
+  REQUIRE(changed_values[0] == PaletteTestValue);
+}
+
+TEST_CASE("Theme dependencies", "[graphics]") {
+  theme::Dependencies dependencies;
+  REQUIRE_FALSE(dependencies.contains(PaletteTestColor));
+
+  dependencies.add(PaletteTestColor);
+  dependencies.add(PaletteTestColor);
+  dependencies.add(PaletteTestValue);
+  REQUIRE(dependencies.contains(PaletteTestColor));
+  REQUIRE_FALSE(dependencies.contains(PaletteTestOtherColor));
+  REQUIRE(dependencies.contains(PaletteTestValue));
+
+  dependencies.clear();
+  REQUIRE_FALSE(dependencies.contains(PaletteTestColor));
+  REQUIRE_FALSE(dependencies.contains(PaletteTestValue));
+}
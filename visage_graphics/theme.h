@@ -23,8 +23,10 @@
 
 #include "visage_utils/defines.h"
 
+#include <algorithm>
 #include <map>
 #include <string>
+#include <vector>
 
 #define VISAGE_THEME_COLOR(color, default_color) \
   const ::visage::theme::ColorId color = ::visage::theme::ColorId::nextId(#color, __FILE__, default_color)
@@ -238,8 +240,40 @@ namespace visage::theme {
         return &instance;
       }
 
-      unsigned int next_id_ = 0;
-      std::map<OverrideId, std::string> name_map_ = { { OverrideId(0), "Global" } };
+      unsigned int next_id_ = kDefaultId + 1;
+      std::map<OverrideId, std::string> name_map_ = { { OverrideId(kDefaultId), "Global" } };
     };
   };
+
+  // Theme entries read while recording a frame so palette edits can redraw only what uses them.
+  // Kept sorted so repeated reads while drawing don't scan the whole list.
+  class Dependencies {
+  public:
+    void add(ColorId color_id) { insertSorted(colors_, color_id); }
+    void add(ValueId value_id) { insertSorted(values_, value_id); }
+
+    bool contains(ColorId color_id) const {
+      return std::binary_search(colors_.begin(), colors_.end(), color_id);
+    }
+
+    bool contains(ValueId value_id) const {
+      return std::binary_search(values_.begin(), values_.end(), value_id);
+    }
+
+    void clear() {
+      colors_.clear();
+      values_.clear();
+    }
+
+  private:
+    template<typename T>
+    static void insertSorted(std::vector<T>& ids, T id) {
+      auto position = std::lower_bound(ids.begin(), ids.end(), id);
+      if (position == ids.end() || *position != id)
+        ids.insert(position, id);
+    }
+
+    std::vector<ColorId> colors_;
+    std::vector<ValueId> values_;
+  };
 }
\ No newline at end of file
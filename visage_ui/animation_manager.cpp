@@ -0,0 +1,75 @@
+/* Copyright Vital Audio, LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "animation_manager.h"
+
+#include <algorithm>
+
+namespace visage {
+  void AnimationManager::startAnimating(AnimationProgress* animation) {
+    if (std::find(animating_.begin(), animating_.end(), animation) == animating_.end()) {
+      animating_.push_back(animation);
+      animation->notifyAdvanced();
+    }
+  }
+
+  void AnimationManager::removeAnimation(AnimationProgress* animation) {
+    animating_.erase(std::remove(animating_.begin(), animating_.end(), animation), animating_.end());
+  }
+
+  void AnimationManager::addListener(FrameClockListener* listener) {
+    if (std::find(listeners_.begin(), listeners_.end(), listener) == listeners_.end())
+      listeners_.push_back(listener);
+  }
+
+  void AnimationManager::removeListener(FrameClockListener* listener) {
+    listeners_.erase(std::remove(listeners_.begin(), listeners_.end(), listener), listeners_.end());
+  }
+
+  void AnimationManager::advance(double time) {
+    double delta_ms = idle_ ? 0.0 : (time - last_time_) * 1000.0;
+    last_time_ = time;
+
+    for (int i = 0; i < animating_.size();) {
+      AnimationProgress* animation = animating_[i];
+      bool animating = animation->advance(delta_ms);
+      animation->notifyAdvanced();
+
+      if (animating)
+        ++i;
+      else {
+        animating_[i] = animating_.back();
+        animating_.pop_back();
+      }
+    }
+
+    for (int i = 0; i < listeners_.size();) {
+      if (listeners_[i]->frameClockStep())
+        ++i;
+      else {
+        listeners_[i] = listeners_.back();
+        listeners_.pop_back();
+      }
+    }
+
+    idle_ = animating_.empty();
+  }
+}
@@ -0,0 +1,67 @@
+/* Copyright Vital Audio, LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "visage_graphics/animation.h"
+
+#include <vector>
+
+namespace visage {
+  // Stepped once per frame clock tick. Returning false stops the steps; listening keeps the
+  // clock running, so listeners should stop as soon as they have nothing to wait for.
+  class FrameClockListener {
+  public:
+    virtual ~FrameClockListener() = default;
+    virtual bool frameClockStep() = 0;
+  };
+
+  class AnimationManager : public AnimationClock {
+  public:
+    static AnimationManager& instance() {
+      static AnimationManager instance;
+      return instance;
+    }
+
+    AnimationManager(const AnimationManager&) = delete;
+    AnimationManager& operator=(const AnimationManager&) = delete;
+
+    void startAnimating(AnimationProgress* animation) override;
+    void removeAnimation(AnimationProgress* animation) override;
+
+    void addListener(FrameClockListener* listener);
+    void removeListener(FrameClockListener* listener);
+
+    void advance(double time);
+    int numAnimating() const { return animating_.size(); }
+    int numListeners() const { return listeners_.size(); }
+    bool isAnimating() const { return !animating_.empty() || !listeners_.empty(); }
+
+  private:
+    AnimationManager() = default;
+    ~AnimationManager() override = default;
+
+    std::vector<AnimationProgress*> animating_;
+    std::vector<FrameClockListener*> listeners_;
+    double last_time_ = 0.0;
+    bool idle_ = true;
+  };
+}
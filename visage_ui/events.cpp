@@ -26,6 +26,193 @@
 
 namespace visage {
 
+  TimerWheel::TimerWheel() {
+    for (auto& level : slots_) {
+      for (auto& slot : level)
+        slot.previous = slot.next = &slot;
+    }
+  }
+
+  void TimerWheel::schedule(EventTimer* timer, long long expiry) {
+    TimerLink* link = &timer->link_;
+    if (link->next)
+      unlink(link);
+    else
+      num_timers_++;
+
+    link->expiry = expiry;
+    insert(link, current_time_ + 1);
+  }
+
+  void TimerWheel::unschedule(EventTimer* timer) {
+    TimerLink* link = &timer->link_;
+    if (link->next == nullptr)
+      return;
+
+    unlink(link);
+    num_timers_--;
+  }
+
+  void TimerWheel::insert(TimerLink* link, long long earliest_time) {
+    long long expiry = std::max(link->expiry, earliest_time);
+    long long delta = expiry - current_time_;
+    VISAGE_ASSERT(delta <= kMaxDelay);
+
+    int level = 0;
+    while (level + 1 < kLevels && delta >= (1LL << ((level + 1) * kSlotBits)))
+      level++;
+
+    int slot = (expiry >> (level * kSlotBits)) & kSlotMask;
+    TimerLink* head = &slots_[level][slot];
+    link->previous = head->previous;
+    link->next = head;
+    head->previous->next = link;
+    head->previous = link;
+    link->level = level;
+    link->slot = slot;
+    occupied_[level] |= 1ULL << slot;
+  }
+
+  void TimerWheel::unlink(TimerLink* link) {
+    link->previous->next = link->next;
+    link->next->previous = link->previous;
+    link->previous = link->next = nullptr;
+
+    TimerLink* head = &slots_[link->level][link->slot];
+    if (head->next == head)
+      occupied_[link->level] &= ~(1ULL << link->slot);
+  }
+
+  void TimerWheel::cascade(int level) {
+    int slot = (current_time_ >> (level * kSlotBits)) & kSlotMask;
+    TimerLink* head = &slots_[level][slot];
+    while (head->next != head) {
+      TimerLink* link = head->next;
+      unlink(link);
+      insert(link, current_time_);
+    }
+  }
+
+  void TimerWheel::expireSlot(int slot, long long current_time) {
+    TimerLink* head = &slots_[0][slot];
+    if (head->next == head)
+      return;
+
+    TimerLink pending;
+    pending.next = head->next;
+    pending.previous = head->previous;
+    pending.next->previous = &pending;
+    pending.previous->next = &pending;
+    head->next = head->previous = head;
+    occupied_[0] &= ~(1ULL << slot);
+
+    while (pending.next != &pending) {
+      TimerLink* link = pending.next;
+      unlink(link);
+      EventTimer* timer = link->timer;
+      link->expiry = current_time + timer->ms_;
+      insert(link, current_time_ + 1);
+      timer->timerCallback();
+    }
+  }
+
+  void TimerWheel::advance(long long current_time) {
+    if (num_timers_ == 0) {
+      current_time_ = current_time;
+      return;
+    }
+
+    if (current_time < current_time_)
+      rebase(current_time);
+
+    while (current_time_ < current_time) {
+      if (num_timers_ == 0) {
+        current_time_ = current_time;
+        return;
+      }
+
+      int lowest_level = 0;
+      while (occupied_[lowest_level] == 0)
+        lowest_level++;
+
+      if (lowest_level > 0) {
+        long long level_mask = (1LL << (lowest_level * kSlotBits)) - 1;
+        long long next_cascade = (current_time_ | level_mask) + 1;
+        if (next_cascade > current_time) {
+          current_time_ = current_time;
+          return;
+        }
+        current_time_ = next_cascade - 1;
+      }
+
+      current_time_++;
+      if ((current_time_ & kSlotMask) == 0) {
+        int top_level = 1;
+        while (top_level + 1 < kLevels && ((current_time_ >> (top_level * kSlotBits)) & kSlotMask) == 0)
+          top_level++;
+
+        for (int level = top_level; level > 0; --level)
+          cascade(level);
+      }
+
+      expireSlot(current_time_ & kSlotMask, current_time);
+    }
+  }
+
+  void TimerWheel::rebase(long long current_time) {
+    long long offset = current_time - current_time_;
+    TimerLink all;
+    all.previous = all.next = &all;
+
+    for (int level = 0; level < kLevels; ++level) {
+      for (int slot = 0; slot < kNumSlots; ++slot) {
+        TimerLink* head = &slots_[level][slot];
+        while (head->next != head) {
+          TimerLink* link = head->next;
+          unlink(link);
+          link->previous = all.previous;
+          link->next = &all;
+          all.previous->next = link;
+          all.previous = link;
+        }
+      }
+    }
+
+    current_time_ = current_time;
+    while (all.next != &all) {
+      TimerLink* link = all.next;
+      all.next = link->next;
+      link->expiry += offset;
+      insert(link, current_time_ + 1);
+    }
+  }
+
+  long long TimerWheel::nextDeadline() const {
+    if (num_timers_ == 0)
+      return -1;
+
+    long long deadline = -1;
+    for (int level = 0; level < kLevels; ++level) {
+      if (occupied_[level] == 0)
+        continue;
+
+      long long base = current_time_ >> (level * kSlotBits);
+      for (int i = 1; i <= kNumSlots; ++i) {
+        int slot = (base + i) & kSlotMask;
+        if ((occupied_[level] & (1ULL << slot)) == 0)
+          continue;
+
+        const TimerLink* head = &slots_[level][slot];
+        for (const TimerLink* link = head->next; link != head; link = link->next) {
+          if (deadline < 0 || link->expiry < deadline)
+            deadline = link->expiry;
+        }
+        break;
+      }
+    }
+    return deadline;
+  }
+
   EventTimer::~EventTimer() {
     if (isRunning())
       stopTimer();
@@ -35,11 +222,8 @@ namespace visage {
     VISAGE_ASSERT(ms > 0);
 
     if (ms > 0) {
-      if (!isRunning())
-        EventManager::instance().addTimer(this);
-
-      last_run_time_ = time::milliseconds();
       ms_ = ms;
+      EventManager::instance().addTimer(this);
     }
   }
 
@@ -50,42 +234,63 @@ namespace visage {
     }
   }
 
-  inline bool EventTimer::checkTimer(long long current_time) {
-    VISAGE_ASSERT(isRunning());
-
-    if (current_time - last_run_time_ >= ms_) {
-      last_run_time_ = current_time;
-      timerCallback();
-      return true;
-    }
-
-    return false;
-  }
-
   void EventManager::addTimer(EventTimer* timer) {
-    timers_.push_back(timer);
+    long long current_time = time::milliseconds();
+    if (timer_wheel_.numTimers() == 0)
+      timer_wheel_.advance(current_time);
+    timer_wheel_.schedule(timer, current_time + timer->intervalMs());
   }
 
   void EventManager::removeTimer(const EventTimer* timer) {
-    auto it = std::find(timers_.begin(), timers_.end(), timer);
-    if (it != timers_.end())
-      timers_.erase(it);
+    timer_wheel_.unschedule(const_cast<EventTimer*>(timer));
   }
 
   void EventManager::addCallback(std::function<void()> callback) {
-    callbacks_.push_back(std::move(callback));
+    callbacks_.push(std::move(callback));
+    if (!wakeup_pending_.exchange(true, std::memory_order_acq_rel)) {
+      if (auto wakeup = wakeup_function_.load())
+        wakeup();
+    }
   }
 
   void EventManager::checkEventTimers() {
-    long long current_time = time::milliseconds();
-    std::vector<EventTimer*> timers = timers_;
-    std::vector<std::function<void()>> callbacks = std::move(callbacks_);
+    checkEventTimers(time::milliseconds());
+  }
+
+  void EventManager::checkEventTimers(long long current_time) {
+    std::function<void()> callback;
+    while (running_callbacks_.size() < kMaxCallbacksPerCheck && callbacks_.tryPop(callback))
+      running_callbacks_.push_back(std::move(callback));
+
+    // Posts that landed after the last pop saw the flag still set and skipped their wakeup, so
+    // drain once more after clearing it.
+    wakeup_pending_.exchange(false, std::memory_order_acq_rel);
+    while (running_callbacks_.size() < kMaxCallbacksPerCheck && callbacks_.tryPop(callback))
+      running_callbacks_.push_back(std::move(callback));
+
+    timer_wheel_.advance(current_time);
+
+    std::vector<std::function<void()>> callbacks = std::move(running_callbacks_);
+    for (auto& running_callback : callbacks)
+      running_callback();
+
+    callbacks.clear();
+    if (running_callbacks_.empty())
+      running_callbacks_ = std::move(callbacks);
+  }
+
+  long long EventManager::nextDeadline() const {
+    return timer_wheel_.nextDeadline();
+  }
 
-    for (auto timer : timers)
-      timer->checkTimer(current_time);
+  long long EventManager::millisecondsUntilNextDeadline(long long current_time) const {
+    if (hasPendingCallbacks())
+      return 0;
 
-    for (auto& callback : callbacks)
-      callback();
+    long long deadline = timer_wheel_.nextDeadline();
+    if (deadline < 0)
+      return -1;
+    return std::max(0LL, deadline - current_time);
   }
 
   MouseEvent MouseEvent::relativeTo(const Frame* new_frame) const {
@@ -23,6 +23,7 @@
 
 #include "visage_utils/defines.h"
 #include "visage_utils/events.h"
+#include "visage_utils/lock_free.h"
 #include "visage_utils/space.h"
 
 #include <functional>
@@ -31,14 +32,59 @@
 namespace visage {
   class Frame;
 
+  class EventTimer;
+
+  struct TimerLink {
+    TimerLink* previous = nullptr;
+    TimerLink* next = nullptr;
+    EventTimer* timer = nullptr;
+    long long expiry = 0;
+    int level = -1;
+    int slot = -1;
+  };
+
+  class TimerWheel {
+  public:
+    static constexpr int kLevels = 6;
+    static constexpr int kSlotBits = 6;
+    static constexpr int kNumSlots = 1 << kSlotBits;
+    static constexpr long long kSlotMask = kNumSlots - 1;
+    static constexpr long long kMaxDelay = (1LL << (kLevels * kSlotBits)) - 1;
+
+    TimerWheel();
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    void schedule(EventTimer* timer, long long expiry);
+    void unschedule(EventTimer* timer);
+    void advance(long long current_time);
+    long long nextDeadline() const;
+
+    int numTimers() const { return num_timers_; }
+    long long currentTime() const { return current_time_; }
+
+  private:
+    void insert(TimerLink* link, long long earliest_time);
+    void unlink(TimerLink* link);
+    void cascade(int level);
+    void rebase(long long current_time);
+    void expireSlot(int slot, long long current_time);
+
+    TimerLink slots_[kLevels][kNumSlots];
+    unsigned long long occupied_[kLevels] {};
+    long long current_time_ = -1;
+    int num_timers_ = 0;
+  };
+
   class EventTimer {
   public:
-    EventTimer() = default;
+    EventTimer() { link_.timer = this; }
+    EventTimer(const EventTimer&) = delete;
+    EventTimer& operator=(const EventTimer&) = delete;
     virtual ~EventTimer();
 
     void startTimer(int ms);
     void stopTimer();
-    bool checkTimer(long long current_time);
     virtual void timerCallback() = 0;
 
     bool isRunning() const {
@@ -46,13 +92,19 @@ namespace visage {
       return ms_ > 0;
     }
 
+    int intervalMs() const { return ms_; }
+
   private:
+    friend class TimerWheel;
+
     int ms_ = 0;
-    long long last_run_time_ = 0;
+    TimerLink link_;
   };
 
   class EventManager {
   public:
+    static constexpr int kMaxCallbacksPerCheck = 1024;
+
     static EventManager& instance() {
       static EventManager instance;
       return instance;
@@ -64,14 +116,23 @@ namespace visage {
     void addTimer(EventTimer* timer);
     void removeTimer(const EventTimer* timer);
     void addCallback(std::function<void()> function);
+    void setWakeupFunction(void (*wakeup)()) { wakeup_function_ = wakeup; }
+    bool hasPendingCallbacks() const { return !callbacks_.empty(); }
     void checkEventTimers();
+    void checkEventTimers(long long current_time);
+
+    long long nextDeadline() const;
+    long long millisecondsUntilNextDeadline(long long current_time) const;
 
   private:
     EventManager() = default;
     ~EventManager() = default;
 
-    std::vector<EventTimer*> timers_ {};
-    std::vector<std::function<void()>> callbacks_ {};
+    TimerWheel timer_wheel_;
+    MpscQueue<std::function<void()>> callbacks_;
+    std::vector<std::function<void()>> running_callbacks_;
+    std::atomic<bool> wakeup_pending_ = false;
+    std::atomic<void (*)()> wakeup_function_ = nullptr;
   };
 
   static void runOnEventThread(std::function<void()> function) {
@@ -21,6 +21,7 @@
 
 #include "frame.h"
 
+#include "animation_manager.h"
 #include "visage_graphics/theme.h"
 
 namespace visage {
@@ -53,6 +54,10 @@ namespace visage {
     }
   }
 
+  void Frame::addAnimation(AnimationProgress& animation) {
+    animation.setClock(&AnimationManager::instance(), [this] { redraw(); });
+  }
+
   void Frame::addChild(Frame* child, bool make_visible) {
     VISAGE_ASSERT(child && child != this);
     if (child == nullptr)
@@ -151,6 +156,16 @@ namespace visage {
     if (bounds_ == bounds && native_bounds_ == new_native_bounds)
       return;
 
+    if (bounds_.width() == bounds.width() && bounds_.height() == bounds.height() &&
+        native_bounds_.width() == new_native_bounds.width() &&
+        native_bounds_.height() == new_native_bounds.height()) {
+      // Recorded shapes are relative to the region so a move only needs recompositing
+      bounds_ = bounds;
+      native_bounds_ = new_native_bounds;
+      region_.setPosition(native_bounds_.x(), native_bounds_.y());
+      return;
+    }
+
     bounds_ = bounds;
     native_bounds_ = new_native_bounds;
     region_.setBounds(native_bounds_.x(), native_bounds_.y(), native_bounds_.width(),
@@ -307,6 +322,7 @@ namespace visage {
       return;
 
     redrawing_ = false;
+    theme_dependencies_.clear();
     region_.invalidate();
     region_.setNeedsLayer(requiresLayer());
     if (width() <= 0 || height() <= 0) {
@@ -321,7 +337,11 @@ namespace visage {
     if (palette_)
       canvas.setPalette(palette_);
 
+    canvas.setThemeDependencies(&theme_dependencies_);
+    recording_theme_ = true;
     on_draw_.callback(canvas);
+    recording_theme_ = false;
+    canvas.setThemeDependencies(nullptr);
     if (alpha_transparency_ != 1.0f) {
       canvas.setBlendMode(BlendMode::Mult);
       canvas.setColor(Color(0xffffffff).withAlpha(alpha_transparency_));
@@ -355,7 +375,24 @@ namespace visage {
     post_effect_ = nullptr;
   }
 
+  void Frame::redrawThemeDependents(theme::ColorId color_id) {
+    if (theme_dependencies_.contains(color_id))
+      redraw();
+    for (Frame* child : children_)
+      child->redrawThemeDependents(color_id);
+  }
+
+  void Frame::redrawThemeDependents(theme::ValueId value_id) {
+    if (theme_dependencies_.contains(value_id))
+      redraw();
+    for (Frame* child : children_)
+      child->redrawThemeDependents(value_id);
+  }
+
   float Frame::paletteValue(theme::ValueId value_id) const {
+    if (recording_theme_)
+      theme_dependencies_.add(value_id);
+
     if (palette_) {
       const Frame* frame = this;
       float result = 0.0f;
@@ -373,6 +410,9 @@ namespace visage {
   }
 
   Brush Frame::paletteColor(theme::ColorId color_id) const {
+    if (recording_theme_)
+      theme_dependencies_.add(color_id);
+
     if (palette_) {
       Brush result;
       const Frame* frame = this;
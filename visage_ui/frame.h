@@ -33,6 +33,7 @@
 #include <vector>
 
 namespace visage {
+  class AnimationProgress;
   class Frame;
 
   struct FrameEventHandler {
@@ -139,6 +140,11 @@ namespace visage {
         child->redrawAll();
     }
 
+    void redrawThemeDependents(theme::ColorId color_id);
+    void redrawThemeDependents(theme::ValueId value_id);
+
+    void addAnimation(AnimationProgress& animation);
+
     Region* region() { return &region_; }
 
     void setPostEffect(PostEffect* post_effect);
@@ -411,6 +417,8 @@ namespace visage {
     float dpi_scale_ = 1.0f;
     Palette* palette_ = nullptr;
     theme::OverrideId palette_override_;
+    mutable theme::Dependencies theme_dependencies_;
+    bool recording_theme_ = false;
     bool initialized_ = false;
 
     PostEffect* post_effect_ = nullptr;
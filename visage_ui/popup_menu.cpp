@@ -52,8 +52,11 @@ namespace visage {
   float PopupList::renderWidth() const {
     float width = paletteValue(PopupMinWidth);
     float x_padding = paletteValue(PopupSelectionPadding) + paletteValue(PopupTextPadding);
+    auto measure = [this](auto* characters, size_t size) {
+      return font_.stringWidth(characters, size);
+    };
     for (const PopupMenu& option : options_) {
-      float string_width = font_.stringWidth(option.name().c_str(), option.name().size()) + 2 * x_padding;
+      float string_width = option.name().visitCharacters(measure) + 2 * x_padding;
       width = std::max(width, string_width);
     }
 
@@ -69,7 +72,7 @@ namespace visage {
       if (options_[hover_index_].hasOptions()) {
         for (Listener* listener : listeners_)
           listener->subMenuSelected(options_[hover_index_], yForIndex(hover_index_), this);
-        menu_open_index_ = hover_index_;
+        setOpenMenu(hover_index_);
       }
       else {
         for (Listener* listener : listeners_)
@@ -84,14 +87,14 @@ namespace visage {
     int option_height = paletteValue(PopupOptionHeight);
     for (int i = 0; i < options_.size(); ++i) {
       if (!options_[i].isBreak() && position.y >= y && position.y < y + option_height) {
-        hover_index_ = i;
+        setHoverIndex(i);
         return;
       }
 
       y += option_height;
     }
 
-    hover_index_ = -1;
+    setHoverIndex(-1);
   }
 
   void PopupList::selectFromPosition(Point position) {
@@ -100,8 +103,6 @@ namespace visage {
   }
 
   void PopupList::draw(Canvas& canvas) {
-    static constexpr float kTriangleWidthRatio = 0.25f;
-
     Brush background = canvas.color(PopupMenuBackground).withMultipliedAlpha(opacity_);
     Brush border = canvas.color(PopupMenuBorder).withMultipliedAlpha(opacity_);
     canvas.setColor(background);
@@ -109,17 +110,22 @@ namespace visage {
 
     canvas.setColor(border);
     canvas.roundedRectangleBorder(0, 0, width(), height(), 8.0f, 1);
+  }
+
+  void PopupList::drawScrolledContent(Canvas& canvas) {
+    static constexpr float kTriangleWidthRatio = 0.25f;
 
+    Bounds view = scrolledContentBounds();
     canvas.setColor(PopupMenuText);
     int selection_padding = paletteValue(PopupSelectionPadding);
     int x_padding = selection_padding + paletteValue(PopupTextPadding);
     int option_height = paletteValue(PopupOptionHeight);
-    int y = selection_padding - yPosition();
+    int y = selection_padding - view.y();
 
     Brush text = canvas.color(PopupMenuText).withMultipliedAlpha(opacity_);
     Brush selected_text = canvas.color(PopupMenuSelectionText).withMultipliedAlpha(opacity_);
     for (int i = 0; i < options_.size(); ++i) {
-      if (y + option_height > 0 && y < height()) {
+      if (y + option_height > 0 && y < view.height()) {
         if (options_[i].isBreak())
           canvas.rectangle(x_padding, y + option_height / 2, width() - 2 * x_padding, 1);
         else {
@@ -134,7 +140,7 @@ namespace visage {
             canvas.setColor(text);
 
           int popup_font_size = paletteValue(PopupFontSize);
-          Font font(popup_font_size, font_.fontData(), font_.dataSize());
+          Font font = font_.withSize(popup_font_size);
           canvas.text(options_[i].name(), font, Font::kLeft, x_padding, y, width(), option_height);
 
           if (options_[i].hasOptions()) {
@@ -171,7 +177,7 @@ namespace visage {
     if (!isVisible())
       return;
 
-    hover_index_ = menu_open_index_;
+    setHoverIndex(menu_open_index_);
     for (Listener* listener : listeners_)
       listener->mouseMovedOnMenu(e.relativeTo(this).position, this);
 
@@ -219,6 +225,7 @@ namespace visage {
   PopupMenuFrame::PopupMenuFrame(PopupMenu menu) :
       menu_(std::move(menu)), font_(10, fonts::Lato_Regular_ttf) {
     opacity_animation_.setTargetValue(1.0f);
+    addAnimation(opacity_animation_);
     setAcceptsKeystrokes(true);
     setIgnoresMouseEvents(true, true);
 
@@ -236,9 +243,7 @@ namespace visage {
     for (auto& list : lists_)
       list.setOpacity(opacity);
 
-    if (opacity_animation_.isAnimating())
-      redraw();
-    else if (parent_ && !opacity_animation_.isTargeting())
+    if (!opacity_animation_.isAnimating() && parent_ && !opacity_animation_.isTargeting())
       exit();
   }
 
@@ -252,7 +257,7 @@ namespace visage {
     for (int i = 1; i < kMaxSubMenus; ++i)
       lists_[i].setVisible(false);
 
-    font_ = Font(paletteValue(PopupFontSize), font_.fontData(), font_.dataSize());
+    font_ = font_.withSize(paletteValue(PopupFontSize));
     setListFonts(font_);
 
     lists_[0].setOptions(menu_.options());
@@ -416,9 +421,12 @@ namespace visage {
     setVisible(true);
     text_ = text;
 
-    Font font(paletteValue(PopupFontSize), font_.fontData(), font_.dataSize(), dpiScale());
+    Font font = font_.withSize(paletteValue(PopupFontSize)).withDpiScale(dpiScale());
     int x_padding = paletteValue(PopupSelectionPadding) + paletteValue(PopupTextPadding);
-    int width = font.stringWidth(text.c_str(), text.length()) + 2 * x_padding;
+    float text_width = text.visitCharacters([&font](auto* characters, size_t size) {
+      return font.stringWidth(characters, size);
+    });
+    int width = text_width + 2 * x_padding;
     int height = paletteValue(PopupOptionHeight);
     int x = bounds.xCenter() - width / 2;
     int y = bounds.yCenter() - height / 2;
@@ -436,7 +444,7 @@ namespace visage {
   }
 
   void ValueDisplay::draw(Canvas& canvas) {
-    Font font(canvas.value(PopupFontSize), font_.fontData(), font_.dataSize());
+    Font font = font_.withSize(canvas.value(PopupFontSize));
     canvas.setColor(PopupMenuBackground);
     canvas.roundedRectangle(0, 0, width(), height(), 8.0f);
 
@@ -80,10 +80,16 @@ namespace visage {
       virtual void mouseUpOutside(Point position, PopupList* list) = 0;
     };
 
-    PopupList() = default;
+    PopupList() { setScrollCaching(true); }
 
-    void setOptions(std::vector<PopupMenu> options) { options_ = std::move(options); }
-    void setFont(const Font& font) { font_ = font.withDpiScale(dpiScale()); }
+    void setOptions(std::vector<PopupMenu> options) {
+      options_ = std::move(options);
+      redrawScrolledContent();
+    }
+    void setFont(const Font& font) {
+      font_ = font.withDpiScale(dpiScale());
+      redrawScrolledContent();
+    }
 
     float renderHeight() const;
     float renderWidth() const;
@@ -95,10 +101,11 @@ namespace visage {
     const PopupMenu& option(int index) const { return options_[index]; }
     void selectHoveredIndex();
     void setHoverFromPosition(Point position);
-    void setNoHover() { hover_index_ = -1; }
+    void setNoHover() { setHoverIndex(-1); }
     void selectFromPosition(Point position);
 
     void draw(Canvas& canvas) override;
+    void drawScrolledContent(Canvas& canvas) override;
     void resized() override;
 
     void enableMouseUp(bool enable) { enable_mouse_up_ = enable; }
@@ -118,14 +125,30 @@ namespace visage {
       return result;
     }
     void addListener(Listener* listener) { listeners_.push_back(listener); }
-    void resetOpenMenu() { menu_open_index_ = -1; }
-    void setOpenMenu(int index) { menu_open_index_ = index; }
+    void resetOpenMenu() { setOpenMenu(-1); }
+    void setOpenMenu(int index) {
+      if (menu_open_index_ != index) {
+        menu_open_index_ = index;
+        redrawScrolledContent();
+      }
+    }
     void setOpacity(float opacity) {
+      if (opacity_ == opacity)
+        return;
+
       opacity_ = opacity;
       redraw();
+      redrawScrolledContent();
     }
 
   private:
+    void setHoverIndex(int index) {
+      if (hover_index_ != index) {
+        hover_index_ = index;
+        redrawScrolledContent();
+      }
+    }
+
     std::vector<Listener*> listeners_;
     std::vector<PopupMenu> options_;
     float opacity_ = 0.0f;
@@ -43,9 +43,6 @@ namespace visage {
     float rounding = std::min(width_.setSourceValue() / 2.0f, rounding_);
     float x = left_ ? 0.0f : width() - w;
     canvas.roundedRectangle(x, y_ratio * h, w, height_ratio * h, rounding);
-
-    if (width_.isAnimating() || color_.isAnimating())
-      redraw();
   }
 
   void ScrollBar::mouseEnter(const MouseEvent& e) {
@@ -93,5 +90,26 @@ namespace visage {
     scroll_bar_.setBounds(x, 0, scroll_bar_width, height());
     float h = std::max<float>(height(), std::max(scroll_bar_.viewRange(), scroll_bar_.viewHeight()));
     container_.setBounds(0, -y_position_, width(), h);
+    updateScrolledContent(true);
+  }
+
+  void ScrollableFrame::updateScrolledContent(bool force_redraw) {
+    float margin = scroll_caching_ ? std::round(height() * kScrollCacheMargin) : 0.0f;
+    float cache_height = height() + 2.0f * margin;
+    bool exposed = force_redraw || y_position_ < cache_top_ ||
+                   y_position_ + height() > cache_top_ + scrolled_content_.height() ||
+                   scrolled_content_.height() != cache_height;
+
+    if (exposed) {
+      float max_top = std::max(0.0f, scroll_bar_.viewRange() - cache_height);
+      float top = std::min(max_top, std::max(0.0f, y_position_ - margin));
+      cache_top_ = std::round(dpiScale() * top) / dpiScale();
+    }
+
+    scrolled_content_.setBounds(0, cache_top_ - y_position_, width(), cache_height);
+    if (exposed) {
+      scrolled_content_.redraw();
+      container_.redraw();
+    }
   }
 }
\ No newline at end of file
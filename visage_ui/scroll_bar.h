@@ -32,6 +32,8 @@ namespace visage {
         color_(Animation<float>::kRegularTime, Animation<float>::kEaseOut, Animation<float>::kEaseOut),
         width_(Animation<float>::kRegularTime, Animation<float>::kEaseOut, Animation<float>::kEaseOut) {
       color_.setTargetValue(1.0f);
+      addAnimation(color_);
+      addAnimation(width_);
     }
 
     void draw(Canvas& canvas) override;
@@ -98,8 +100,13 @@ namespace visage {
   public:
     static constexpr float kDefaultSmoothTime = 0.1f;
     static constexpr float kDefaultWheelSensitivity = 100.0f;
+    static constexpr float kScrollCacheMargin = 0.5f;
 
     explicit ScrollableFrame(const std::string& name = "") : Frame(name) {
+      addChild(&scrolled_content_);
+      scrolled_content_.setIgnoresMouseEvents(true, true);
+      scrolled_content_.onDraw() = [this](Canvas& canvas) { drawScrolledContent(canvas); };
+
       addChild(&container_);
       container_.setIgnoresMouseEvents(true, true);
       container_.setVisible(false);
@@ -114,6 +121,26 @@ namespace visage {
 
     void resized() override;
 
+    // Draws content that moves with the scroll position, offset by scrolledContentBounds().y()
+    virtual void drawScrolledContent(Canvas& canvas) { }
+    // Re-records the scrolled content. Redrawing this frame alone leaves it as it was recorded
+    void redrawScrolledContent() { scrolled_content_.redraw(); }
+
+    // With scroll caching the scrolled content is kept in a layer a margin taller than the view
+    // so scrolling samples it at a new offset and only re-records when leaving the margin
+    void setScrollCaching(bool caching) {
+      if (scroll_caching_ == caching)
+        return;
+
+      scroll_caching_ = caching;
+      scrolled_content_.setCached(caching);
+      updateScrolledContent(true);
+    }
+    bool scrollCaching() const { return scroll_caching_; }
+    Bounds scrolledContentBounds() const {
+      return { 0.0f, cache_top_, scrolled_content_.width(), scrolled_content_.height() };
+    }
+
     void addScrolledChild(Frame* frame, bool make_visible = true) {
       container_.setVisible(true);
       container_.addChild(frame);
@@ -187,11 +214,14 @@ namespace visage {
       y_position_ = std::round(dpiScale() * position) / dpiScale();
       container_.setTopLeft(container_.x(), -y_position_);
       scroll_bar_.setPosition(position);
-      redraw();
-      container_.redraw();
+      if (!scroll_caching_)
+        redraw();
+      updateScrolledContent(false);
       on_scroll_.callback(this);
     }
 
+    void updateScrolledContent(bool force_redraw);
+
     bool smoothScroll(float offset) {
       float max = maxScroll();
       if (max <= 0)
@@ -231,6 +261,9 @@ namespace visage {
     float smooth_position_ = 0.0f;
     float y_position_ = 0;
     bool scroll_bar_left_ = false;
+    bool scroll_caching_ = false;
+    float cache_top_ = 0.0f;
+    Frame scrolled_content_;
     Frame container_;
     ScrollBar scroll_bar_;
     float sensitivity_ = kDefaultWheelSensitivity;
@@ -0,0 +1,134 @@
+/* Copyright Vital Audio, LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "visage_ui/animation_manager.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace visage;
+
+TEST_CASE("Animation manager advances on the frame clock", "[ui]") {
+  static constexpr double kFrameTime = 0.01;
+  AnimationManager& manager = AnimationManager::instance();
+  Animation<float> animation(100);
+  animation.setTargetValue(1.0f);
+  animation.setClock(&manager);
+  REQUIRE(manager.numAnimating() == 0);
+
+  animation.target(true);
+  REQUIRE(manager.numAnimating() == 1);
+
+  double time = 5.0;
+  manager.advance(time);
+  REQUIRE(animation.update() == 0.0f);
+
+  int frames = 0;
+  while (manager.isAnimating()) {
+    time += kFrameTime;
+    manager.advance(time);
+    frames++;
+    REQUIRE(frames <= 11);
+  }
+
+  REQUIRE(frames >= 10);
+  REQUIRE(animation.update() == 1.0f);
+  REQUIRE_FALSE(animation.isAnimating());
+
+  animation.target(false);
+  REQUIRE(manager.numAnimating() == 1);
+  time += 10.0;
+  manager.advance(time);
+  REQUIRE(animation.value() == 1.0f);
+  time += kFrameTime;
+  manager.advance(time);
+  REQUIRE(animation.value() < 1.0f);
+  REQUIRE(animation.value() > 0.8f);
+}
+
+TEST_CASE("Destroyed animations leave the manager", "[ui]") {
+  AnimationManager& manager = AnimationManager::instance();
+  {
+    Animation<float> animation(100);
+    animation.setClock(&manager);
+    animation.target(true);
+    REQUIRE(manager.numAnimating() == 1);
+  }
+  REQUIRE(manager.numAnimating() == 0);
+  manager.advance(0.0);
+}
+
+TEST_CASE("Unclocked animations jump when targeted", "[ui]") {
+  Animation<float> animation(100);
+  animation.setTargetValue(2.0f);
+  animation.target(true, true);
+  REQUIRE(animation.update() == 2.0f);
+  animation.target(false, true);
+  REQUIRE(animation.update() == 0.0f);
+}
+
+TEST_CASE("Animations notify their owner on the frame clock", "[ui]") {
+  AnimationManager& manager = AnimationManager::instance();
+  int notifications = 0;
+  Animation<float> animation(100);
+  animation.setClock(&manager, [&notifications] { notifications++; });
+  REQUIRE(notifications == 0);
+
+  animation.target(true);
+  REQUIRE(notifications == 1);
+  REQUIRE(manager.isAnimating());
+
+  animation.target(true);
+  REQUIRE(notifications == 1);
+
+  double time = 1.0;
+  while (manager.isAnimating()) {
+    time += 0.05;
+    manager.advance(time);
+  }
+  REQUIRE(notifications > 2);
+}
+
+TEST_CASE("Copied animations keep their state but not the clock", "[ui]") {
+  AnimationManager& manager = AnimationManager::instance();
+  Animation<float> animation(100);
+  animation.setTargetValue(1.0f);
+  animation.setClock(&manager);
+  animation.target(true);
+  REQUIRE(manager.numAnimating() == 1);
+
+  {
+    Animation<float> copy = animation;
+    REQUIRE(copy.clock() == nullptr);
+    REQUIRE(copy.isTargeting());
+    REQUIRE(manager.numAnimating() == 1);
+
+    Animation<float> assigned(50);
+    assigned.setClock(&manager);
+    assigned = animation;
+    REQUIRE(assigned.clock() == &manager);
+    REQUIRE(manager.numAnimating() == 2);
+  }
+
+  REQUIRE(manager.numAnimating() == 1);
+  animation.target(false, true);
+  manager.advance(0.0);
+  REQUIRE(manager.numAnimating() == 0);
+}
@@ -0,0 +1,249 @@
+/* Copyright Vital Audio, LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "visage_ui/events.h"
+#include "visage_utils/time_utils.h"
+
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace visage;
+
+namespace {
+  class RecordingTimer : public EventTimer {
+  public:
+    void timerCallback() override {
+      fire_times.push_back(current_time);
+      if (on_fire)
+        on_fire();
+    }
+
+    long long current_time = 0;
+    std::vector<long long> fire_times;
+    std::function<void()> on_fire;
+  };
+
+  void runUntil(std::vector<RecordingTimer*> timers, long long& current_time, long long end_time) {
+    for (; current_time <= end_time; ++current_time) {
+      for (auto* timer : timers)
+        timer->current_time = current_time;
+      EventManager::instance().checkEventTimers(current_time);
+    }
+  }
+}
+
+TEST_CASE("Event timers repeat at their interval", "[ui]") {
+  long long current_time = time::milliseconds();
+  RecordingTimer timer1, timer7, timer64, timer100, timer1000;
+  std::vector<RecordingTimer*> timers = { &timer1, &timer7, &timer64, &timer100, &timer1000 };
+  std::vector<int> intervals = { 1, 7, 64, 100, 1000 };
+  for (int i = 0; i < timers.size(); ++i)
+    timers[i]->startTimer(intervals[i]);
+
+  runUntil(timers, current_time, current_time + 10000);
+
+  for (int i = 0; i < timers.size(); ++i) {
+    auto& fire_times = timers[i]->fire_times;
+    REQUIRE(fire_times.size() >= 10000 / intervals[i] - 1);
+    for (int t = 1; t < fire_times.size(); ++t)
+      REQUIRE(fire_times[t] - fire_times[t - 1] == intervals[i]);
+  }
+
+  for (auto* timer : timers)
+    timer->stopTimer();
+
+  REQUIRE(EventManager::instance().nextDeadline() < 0);
+}
+
+TEST_CASE("Event timers with long intervals", "[ui]") {
+  static constexpr int kInterval = 3 * 60 * 60 * 1000;
+  long long start_time = time::milliseconds();
+  RecordingTimer timer;
+  timer.startTimer(kInterval);
+
+  long long deadline = EventManager::instance().nextDeadline();
+  REQUIRE(deadline >= start_time + kInterval);
+  REQUIRE(deadline <= time::milliseconds() + kInterval);
+
+  EventManager::instance().checkEventTimers(deadline - 1);
+  REQUIRE(timer.fire_times.empty());
+  REQUIRE(EventManager::instance().millisecondsUntilNextDeadline(deadline - 1) == 1);
+
+  timer.current_time = deadline;
+  EventManager::instance().checkEventTimers(deadline);
+  REQUIRE(timer.fire_times.size() == 1);
+  REQUIRE(EventManager::instance().nextDeadline() == deadline + kInterval);
+}
+
+TEST_CASE("Event timers stopped during dispatch", "[ui]") {
+  long long current_time = time::milliseconds();
+  RecordingTimer first, second;
+  first.on_fire = [&second] { second.stopTimer(); };
+  first.startTimer(10);
+  second.startTimer(10);
+
+  runUntil({ &first, &second }, current_time, current_time + 100);
+  REQUIRE(first.fire_times.size() >= 9);
+  REQUIRE(second.fire_times.size() <= 1);
+  REQUIRE_FALSE(second.isRunning());
+  first.stopTimer();
+}
+
+TEST_CASE("Event timers restarted during dispatch", "[ui]") {
+  long long current_time = time::milliseconds();
+  RecordingTimer timer;
+  timer.on_fire = [&timer] {
+    if (timer.fire_times.size() == 1)
+      timer.startTimer(50);
+  };
+  timer.startTimer(5);
+
+  runUntil({ &timer }, current_time, current_time + 500);
+  REQUIRE(timer.fire_times.size() >= 3);
+  for (int t = 2; t < timer.fire_times.size(); ++t)
+    REQUIRE(timer.fire_times[t] - timer.fire_times[t - 1] == 50);
+  timer.stopTimer();
+}
+
+TEST_CASE("Event timers survive the clock moving backwards", "[ui]") {
+  long long current_time = time::milliseconds();
+  RecordingTimer timer;
+  timer.startTimer(20);
+
+  long long deadline = EventManager::instance().nextDeadline();
+  EventManager::instance().checkEventTimers(current_time - 1000);
+  REQUIRE(timer.fire_times.empty());
+  REQUIRE(EventManager::instance().nextDeadline() <= deadline - 1000 + 1);
+
+  current_time -= 1000;
+  runUntil({ &timer }, current_time, current_time + 100);
+  REQUIRE(timer.fire_times.size() >= 4);
+  timer.stopTimer();
+}
+
+TEST_CASE("Callbacks posted from many threads", "[ui]") {
+  static constexpr int kNumProducers = 8;
+  static constexpr int kTasksPerProducer = 125000;
+  static constexpr int kTotalTasks = kNumProducers * kTasksPerProducer;
+
+  EventManager& manager = EventManager::instance();
+  static std::atomic<int> wakeups = 0;
+  wakeups = 0;
+  manager.setWakeupFunction([] { wakeups++; });
+
+  std::vector<int> next(kNumProducers, 0);
+  bool in_order = true;
+  int completed = 0;
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kNumProducers; ++p) {
+    producers.emplace_back([&, p] {
+      for (int i = 0; i < kTasksPerProducer; ++i) {
+        runOnEventThread([&, p, i] {
+          in_order = in_order && next[p] == i;
+          next[p]++;
+          completed++;
+        });
+      }
+    });
+  }
+
+  long long current_time = time::milliseconds();
+  int max_batch = 0;
+  while (completed < kTotalTasks) {
+    int before = completed;
+    manager.checkEventTimers(current_time);
+    max_batch = std::max(max_batch, completed - before);
+    if (completed == before)
+      std::this_thread::yield();
+  }
+
+  for (auto& producer : producers)
+    producer.join();
+
+  manager.checkEventTimers(current_time);
+  manager.setWakeupFunction(nullptr);
+
+  REQUIRE(completed == kTotalTasks);
+  REQUIRE(in_order);
+  REQUIRE(max_batch <= EventManager::kMaxCallbacksPerCheck);
+  REQUIRE(wakeups > 0);
+  REQUIRE(wakeups <= kTotalTasks);
+  REQUIRE_FALSE(manager.hasPendingCallbacks());
+}
+
+TEST_CASE("Idle event loop wakes for callbacks posted while draining", "[ui]") {
+  static constexpr int kNumProducers = 4;
+  static constexpr int kBursts = 20000;
+  static constexpr int kBurstSize = 1;
+  static constexpr int kTotalTasks = kNumProducers * kBursts * kBurstSize;
+
+  static std::mutex mutex;
+  static std::condition_variable condition;
+  static bool signaled = false;
+  signaled = false;
+
+  EventManager& manager = EventManager::instance();
+  manager.setWakeupFunction([] {
+    std::lock_guard<std::mutex> lock(mutex);
+    signaled = true;
+    condition.notify_one();
+  });
+
+  std::atomic<int> completed = 0;
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kNumProducers; ++p) {
+    producers.emplace_back([&] {
+      for (int b = 0; b < kBursts; ++b) {
+        for (int i = 0; i < kBurstSize; ++i)
+          runOnEventThread([&] { completed++; });
+        std::this_thread::yield();
+      }
+    });
+  }
+
+  bool lost_wakeup = false;
+  long long current_time = time::milliseconds();
+  while (completed < kTotalTasks && !lost_wakeup) {
+    if (manager.millisecondsUntilNextDeadline(current_time) != 0) {
+      std::unique_lock<std::mutex> lock(mutex);
+      if (!condition.wait_for(lock, std::chrono::seconds(2), [] { return signaled; }))
+        lost_wakeup = manager.hasPendingCallbacks();
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      signaled = false;
+    }
+    manager.checkEventTimers(current_time);
+  }
+
+  for (auto& producer : producers)
+    producer.join();
+
+  manager.checkEventTimers(current_time);
+  manager.setWakeupFunction(nullptr);
+
+  REQUIRE_FALSE(lost_wakeup);
+  REQUIRE(completed == kTotalTasks);
+}
@@ -0,0 +1,178 @@
+/* Copyright Vital Audio, LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "visage_graphics/canvas.h"
+#include "visage_ui/frame.h"
+#include "visage_ui/scroll_bar.h"
+
+#include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace visage;
+
+namespace {
+  VISAGE_THEME_COLOR(FrameTestColor, 0xff112233);
+  VISAGE_THEME_VALUE(FrameTestValue, 2.0f);
+}
+
+TEST_CASE("Moving a frame keeps its recorded drawing", "[ui]") {
+  std::vector<Frame*> redraws;
+  FrameEventHandler handler;
+  handler.request_redraw = [&redraws](Frame* frame) { redraws.push_back(frame); };
+
+  Frame parent;
+  Frame child;
+  parent.addChild(&child);
+  parent.setDrawing(true);
+  parent.setBounds(0, 0, 200, 200);
+  child.setBounds(10, 10, 50, 50);
+  parent.setEventHandler(&handler);
+
+  int resizes = 0;
+  child.onResize() += [&resizes] { resizes++; };
+
+  child.setBounds(40, 20, 50, 50);
+  REQUIRE(redraws.empty());
+  REQUIRE(resizes == 0);
+  REQUIRE(child.x() == 40.0f);
+  REQUIRE(child.y() == 20.0f);
+
+  child.setBounds(40, 20, 60, 50);
+  REQUIRE(redraws.size() == 1);
+  REQUIRE(redraws[0] == &child);
+  REQUIRE(resizes == 1);
+}
+
+TEST_CASE("Theme changes redraw only frames that read them", "[ui]") {
+  std::vector<Frame*> redraws;
+  FrameEventHandler handler;
+  handler.request_redraw = [&redraws](Frame* frame) { redraws.push_back(frame); };
+
+  Frame parent;
+  Frame color_reader;
+  Frame value_reader;
+  parent.addChild(&color_reader);
+  parent.addChild(&value_reader);
+  parent.setBounds(0, 0, 100, 100);
+  color_reader.setBounds(0, 0, 50, 50);
+  value_reader.setBounds(50, 0, 50, 50);
+  color_reader.onDraw() = [&color_reader](Canvas&) { color_reader.paletteColor(FrameTestColor); };
+  value_reader.onDraw() = [&value_reader](Canvas&) { value_reader.paletteValue(FrameTestValue); };
+  parent.setDrawing(true);
+  parent.setEventHandler(&handler);
+
+  Canvas canvas;
+  for (Frame* frame : { &parent, &color_reader, &value_reader }) {
+    frame->redraw();
+    frame->drawToRegion(canvas);
+  }
+  redraws.clear();
+
+  parent.redrawThemeDependents(FrameTestColor);
+  REQUIRE(redraws.size() == 1);
+  REQUIRE(redraws[0] == &color_reader);
+
+  parent.redrawThemeDependents(FrameTestValue);
+  REQUIRE(redraws.size() == 2);
+  REQUIRE(redraws[1] == &value_reader);
+
+  color_reader.drawToRegion(canvas);
+  value_reader.drawToRegion(canvas);
+  redraws.clear();
+  color_reader.onDraw() = [](Canvas&) { };
+  color_reader.redraw();
+  color_reader.drawToRegion(canvas);
+  redraws.clear();
+
+  parent.redrawThemeDependents(FrameTestColor);
+  REQUIRE(redraws.empty());
+}
+
+TEST_CASE("Cached scrolling only re-records outside the margin", "[ui]") {
+  std::vector<Frame*> redraws;
+  FrameEventHandler handler;
+  handler.request_redraw = [&redraws](Frame* frame) { redraws.push_back(frame); };
+
+  Canvas canvas;
+  ScrollableFrame scrollable;
+  Frame scrolled_child;
+  canvas.addRegion(scrollable.region());
+  scrollable.addScrolledChild(&scrolled_child);
+  scrollable.setBounds(0, 0, 100, 100);
+  scrollable.setScrollableHeight(1000);
+  scrollable.setScrollCaching(true);
+  scrollable.setDrawing(true);
+  scrollable.setEventHandler(&handler);
+
+  auto draw = [&] {
+    while (!redraws.empty()) {
+      std::vector<Frame*> drawing;
+      std::swap(drawing, redraws);
+      for (Frame* frame : drawing)
+        frame->drawToRegion(canvas);
+    }
+  };
+  auto content_redraws = [&] {
+    return std::count_if(redraws.begin(), redraws.end(),
+                         [&](Frame* frame) { return frame != &scrollable.scrollBar(); });
+  };
+  scrollable.redraw();
+  scrollable.setYPosition(1);
+  draw();
+  REQUIRE(redraws.empty());
+
+  scrollable.setYPosition(20);
+  scrollable.setYPosition(40);
+  REQUIRE(content_redraws() == 0);
+
+  scrollable.setYPosition(400);
+  REQUIRE(content_redraws() > 0);
+  draw();
+
+  scrollable.setScrollCaching(false);
+  draw();
+  scrollable.setYPosition(410);
+  REQUIRE(content_redraws() > 0);
+}
+
+TEST_CASE("Construct and destroy 100k frames", "[ui][.benchmark]") {
+  static constexpr int kNumFrames = 100000;
+
+  BENCHMARK("Frame construction") {
+    std::vector<std::unique_ptr<Frame>> frames;
+    frames.reserve(kNumFrames);
+    for (int i = 0; i < kNumFrames; ++i)
+      frames.push_back(std::make_unique<Frame>());
+    return frames.size();
+  };
+
+  BENCHMARK("Frame construction with extra callbacks") {
+    std::vector<std::unique_ptr<Frame>> frames;
+    frames.reserve(kNumFrames);
+    for (int i = 0; i < kNumFrames; ++i) {
+      frames.push_back(std::make_unique<Frame>());
+      Frame* frame = frames.back().get();
+      frame->onResize() += [frame] { frame->redraw(); };
+    }
+    return frames.size();
+  };
+}
@@ -21,144 +21,276 @@
 
 #pragma once
 
+#include "defines.h"
+
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <vector>
 
 namespace visage {
 
   struct Dimension {
+    typedef std::function<float(float, float, float, float)> ComputeFunction;
+
+    enum class Op : unsigned char {
+      NativePixels,
+      LogicalPixels,
+      WidthRatio,
+      HeightRatio,
+      ViewMinRatio,
+      ViewMaxRatio,
+      Custom,
+      Add,
+      Subtract,
+      ReverseSubtract,
+      Min,
+      Max,
+      Scale,
+    };
+
+    struct Instruction {
+      Op op = Op::NativePixels;
+      uint16_t custom_index = 0;
+      float value = 0.0f;
+    };
+
+    static constexpr int kMaxInlineInstructions = 16;
+    static constexpr int kMaxStackSize = 32;
+    static constexpr int kMaxCustomFunctions = 1 << 16;
+
     float amount = 0.0f;
-    std::function<float(float, float, float, float)> compute_function = nullptr;
+    // Only set when assigned directly. Takes priority over the expression and is treated as a
+    // custom leaf when combined with other dimensions.
+    ComputeFunction compute_function = nullptr;
 
     float compute(float dpi_scale, float parent_width, float parent_height, float default_value = 0.0f) const {
       if (compute_function)
         return compute_function(amount, dpi_scale, parent_width, parent_height);
-      return default_value;
+      if (size_ == 0)
+        return default_value;
+      return evaluate(dpi_scale, parent_width, parent_height);
     }
 
     int computeInt(float dpi_scale, float parent_width, float parent_height, int default_value = 0) const {
-      if (compute_function)
-        return std::round(compute_function(amount, dpi_scale, parent_width, parent_height));
-      return default_value;
+      if (compute_function == nullptr && size_ == 0)
+        return default_value;
+      return std::round(compute(dpi_scale, parent_width, parent_height));
     }
 
     Dimension() = default;
     Dimension(float amount) { *this = logicalPixels(amount); }
-    Dimension(float amount, std::function<float(float, float, float, float)> compute) :
-        amount(amount), compute_function(std::move(compute)) { }
+    Dimension(float amount, ComputeFunction compute) : amount(amount) {
+      if (compute == nullptr)
+        return;
 
-    static Dimension nativePixels(float pixels) {
-      return Dimension(pixels, [](float amount, float, float, float) { return amount; });
+      custom_functions_.push_back(std::make_shared<const ComputeFunction>(std::move(compute)));
+      push({ Op::Custom, 0, amount });
     }
 
-    static Dimension logicalPixels(float pixels) {
-      return Dimension(pixels, [](float amount, float scale, float, float) { return scale * amount; });
-    }
+    static Dimension nativePixels(float pixels) { return leaf(Op::NativePixels, pixels); }
+    static Dimension logicalPixels(float pixels) { return leaf(Op::LogicalPixels, pixels); }
+    static Dimension widthPercent(float percent) { return leaf(Op::WidthRatio, percent * 0.01f); }
+    static Dimension heightPercent(float percent) { return leaf(Op::HeightRatio, percent * 0.01f); }
+    static Dimension viewMinPercent(float percent) { return leaf(Op::ViewMinRatio, percent * 0.01f); }
+    static Dimension viewMaxPercent(float percent) { return leaf(Op::ViewMaxRatio, percent * 0.01f); }
+
+    static Dimension min(const Dimension& a, const Dimension& b) { return combine(a, b, Op::Min); }
+    static Dimension max(const Dimension& a, const Dimension& b) { return combine(a, b, Op::Max); }
 
-    static Dimension widthPercent(float percent) {
-      float ratio = percent * 0.01f;
-      return Dimension(ratio, [](float amount, float, float parent_width, float) {
-        return amount * parent_width;
-      });
+    Dimension operator+(const Dimension& other) const { return combine(*this, other, Op::Add); }
+
+    Dimension& operator+=(const Dimension& other) {
+      *this = *this + other;
+      return *this;
     }
 
-    static Dimension heightPercent(float percent) {
-      float ratio = percent * 0.01f;
-      return Dimension(ratio, [](float amount, float, float, float parent_height) {
-        return amount * parent_height;
-      });
+    Dimension operator-(const Dimension& other) const { return combine(*this, other, Op::Subtract); }
+
+    Dimension& operator-=(const Dimension& other) {
+      *this = *this - other;
+      return *this;
     }
 
-    static Dimension viewMinPercent(float percent) {
-      float ratio = percent * 0.01f;
-      return Dimension(ratio, [](float amount, float, float parent_width, float parent_height) {
-        return amount * std::min(parent_width, parent_height);
-      });
+    Dimension operator*(float scalar) const {
+      Dimension result;
+      result.amount = amount;
+      result.append(*this);
+      result.push({ Op::Scale, 0, scalar });
+      return result;
     }
 
-    static Dimension viewMaxPercent(float percent) {
-      float ratio = percent * 0.01f;
-      return Dimension(ratio, [](float amount, float, float parent_width, float parent_height) {
-        return amount * std::max(parent_width, parent_height);
-      });
+    friend Dimension operator*(float scalar, const Dimension& dimension) {
+      return dimension * scalar;
     }
 
-    static Dimension min(const Dimension& a, const Dimension& b) {
-      auto amount1 = a.amount;
-      auto amount2 = b.amount;
-      auto compute1 = a.compute_function;
-      auto compute2 = b.compute_function;
-      return Dimension(0.0f, [amount1, amount2, compute1,
-                              compute2](float, float dpi_scale, float parent_width, float parent_height) {
-        return std::min(compute1(amount1, dpi_scale, parent_width, parent_height),
-                        compute2(amount2, dpi_scale, parent_width, parent_height));
-      });
+    Dimension operator/(float scalar) const { return *this * (1.0f / scalar); }
+
+    Dimension min(const Dimension& other) const { return min(*this, other); }
+
+    Dimension max(const Dimension& other) const { return max(*this, other); }
+
+    int numInstructions() const { return size_; }
+    int maxStackSize() const { return max_stack_size_; }
+    const Instruction* instructions() const {
+      return overflow_ ? overflow_->data() : inline_instructions_;
     }
 
-    static Dimension max(const Dimension& a, const Dimension& b) {
-      auto amount1 = a.amount;
-      auto amount2 = b.amount;
-      auto compute1 = a.compute_function;
-      auto compute2 = b.compute_function;
-      return Dimension(0.0f, [amount1, amount2, compute1,
-                              compute2](float, float dpi_scale, float parent_width, float parent_height) {
-        return std::max(compute1(amount1, dpi_scale, parent_width, parent_height),
-                        compute2(amount2, dpi_scale, parent_width, parent_height));
-      });
+  private:
+    static Dimension leaf(Op op, float value) {
+      Dimension result;
+      result.amount = value;
+      result.push({ op, 0, value });
+      return result;
     }
 
-    Dimension operator+(const Dimension& other) const {
-      auto amount1 = amount;
-      auto amount2 = other.amount;
-      auto compute1 = compute_function;
-      auto compute2 = other.compute_function;
-      return Dimension(0.0f, [amount1, amount2, compute1,
-                              compute2](float, float dpi_scale, float parent_width, float parent_height) {
-        return compute1(amount1, dpi_scale, parent_width, parent_height) +
-               compute2(amount2, dpi_scale, parent_width, parent_height);
-      });
+    static Op reversed(Op op) {
+      if (op == Op::Subtract)
+        return Op::ReverseSubtract;
+      if (op == Op::ReverseSubtract)
+        return Op::Subtract;
+      return op;
     }
 
-    Dimension& operator+=(const Dimension& other) {
-      *this = *this + other;
-      return *this;
+    int stackDepth() const { return compute_function ? 1 : std::max(1, max_stack_size_); }
+
+    static Dimension combine(const Dimension& a, const Dimension& b, Op op) {
+      // Evaluating the deeper operand first keeps the stack logarithmic in the number of leaves
+      Dimension result;
+      if (a.stackDepth() >= b.stackDepth()) {
+        result.append(a);
+        result.append(b);
+        result.push({ op, 0, 0.0f });
+      }
+      else {
+        result.append(b);
+        result.append(a);
+        result.push({ reversed(op), 0, 0.0f });
+      }
+      return result;
     }
 
-    Dimension operator-(const Dimension& other) const {
-      auto amount1 = amount;
-      auto amount2 = other.amount;
-      auto compute1 = compute_function;
-      auto compute2 = other.compute_function;
-      return Dimension(0.0f, [amount1, amount2, compute1,
-                              compute2](float, float dpi_scale, float parent_width, float parent_height) {
-        return compute1(amount1, dpi_scale, parent_width, parent_height) -
-               compute2(amount2, dpi_scale, parent_width, parent_height);
-      });
+    void push(const Instruction& instruction) {
+      if (size_ == kMaxInlineInstructions) {
+        overflow_ = std::make_shared<std::vector<Instruction>>();
+        overflow_->reserve(2 * kMaxInlineInstructions + 1);
+        overflow_->assign(inline_instructions_, inline_instructions_ + size_);
+      }
+
+      if (size_ >= kMaxInlineInstructions)
+        overflow_->push_back(instruction);
+      else
+        inline_instructions_[size_] = instruction;
+
+      size_++;
+      int stack_change = instruction.op < Op::Add ? 1 : (instruction.op == Op::Scale ? 0 : -1);
+      stack_size_ += stack_change;
+      max_stack_size_ = std::max(max_stack_size_, stack_size_);
+      VISAGE_ASSERT(max_stack_size_ <= kMaxStackSize);
     }
 
-    Dimension& operator-=(const Dimension& other) {
-      *this = *this - other;
-      return *this;
+    void pushCustom(std::shared_ptr<const ComputeFunction> function, float amount) {
+      VISAGE_ASSERT(custom_functions_.size() < kMaxCustomFunctions);
+      uint16_t index = custom_functions_.size();
+      custom_functions_.push_back(std::move(function));
+      push({ Op::Custom, index, amount });
     }
 
-    Dimension operator*(float scalar) const {
-      auto amount1 = amount;
-      auto compute1 = compute_function;
-      return Dimension(amount1, [compute1, scalar](float amount, float dpi_scale,
-                                                   float parent_width, float parent_height) {
-        return scalar * compute1(amount, dpi_scale, parent_width, parent_height);
-      });
+    void append(const Dimension& other) {
+      if (other.compute_function) {
+        pushCustom(std::make_shared<const ComputeFunction>(other.compute_function), other.amount);
+        return;
+      }
+
+      if (other.size_ == 0) {
+        push({ Op::NativePixels, 0, 0.0f });
+        return;
+      }
+
+      // Programs that have spilled out of the inline storage, or that would overflow the
+      // evaluation stack, are shared as a single custom leaf instead of being copied in. This keeps
+      // every program short no matter how many times expressions are composed.
+      if (other.overflow_ || stack_size_ + other.max_stack_size_ > kMaxStackSize) {
+        std::shared_ptr<const Dimension> program = std::make_shared<const Dimension>(other);
+        pushCustom(std::make_shared<const ComputeFunction>(
+                       [program](float, float dpi_scale, float parent_width, float parent_height) {
+                         return program->evaluate(dpi_scale, parent_width, parent_height);
+                       }),
+                   other.amount);
+        return;
+      }
+
+      int custom_offset = custom_functions_.size();
+      custom_functions_.insert(custom_functions_.end(), other.custom_functions_.begin(),
+                               other.custom_functions_.end());
+
+      const Instruction* other_instructions = other.instructions();
+      for (int i = 0; i < other.size_; ++i) {
+        Instruction instruction = other_instructions[i];
+        if (other.size_ == 1)
+          instruction.value = other.amount;
+        if (instruction.op == Op::Custom)
+          instruction.custom_index += custom_offset;
+        push(instruction);
+      }
     }
 
-    friend Dimension operator*(float scalar, const Dimension& dimension) {
-      return dimension * scalar;
+    float leafValue(const Instruction& instruction, float value, float dpi_scale, float parent_width,
+                    float parent_height) const {
+      switch (instruction.op) {
+      case Op::NativePixels: return value;
+      case Op::LogicalPixels: return dpi_scale * value;
+      case Op::WidthRatio: return value * parent_width;
+      case Op::HeightRatio: return value * parent_height;
+      case Op::ViewMinRatio: return value * std::min(parent_width, parent_height);
+      case Op::ViewMaxRatio: return value * std::max(parent_width, parent_height);
+      case Op::Custom:
+        return (*custom_functions_[instruction.custom_index])(value, dpi_scale, parent_width, parent_height);
+      default: return 0.0f;
+      }
     }
 
-    Dimension operator/(float scalar) const { return *this * (1.0f / scalar); }
+    static float applyOperator(Op op, float a, float b) {
+      switch (op) {
+      case Op::Add: return a + b;
+      case Op::Subtract: return a - b;
+      case Op::ReverseSubtract: return b - a;
+      case Op::Min: return std::min(a, b);
+      case Op::Max: return std::max(a, b);
+      default: return 0.0f;
+      }
+    }
 
-    Dimension min(const Dimension& other) const { return min(*this, other); }
+    float evaluate(float dpi_scale, float parent_width, float parent_height) const {
+      const Instruction* program = instructions();
+      if (size_ == 1)
+        return leafValue(program[0], amount, dpi_scale, parent_width, parent_height);
+
+      float stack[kMaxStackSize];
+      int top = 0;
+      for (int i = 0; i < size_; ++i) {
+        const Instruction& instruction = program[i];
+        if (instruction.op < Op::Add)
+          stack[top++] = leafValue(instruction, instruction.value, dpi_scale, parent_width, parent_height);
+        else if (instruction.op == Op::Scale)
+          stack[top - 1] *= instruction.value;
+        else {
+          top--;
+          stack[top - 1] = applyOperator(instruction.op, stack[top - 1], stack[top]);
+        }
+      }
+      return stack[0];
+    }
 
-    Dimension max(const Dimension& other) const { return max(*this, other); }
+    Instruction inline_instructions_[kMaxInlineInstructions] {};
+    // Never modified once the Dimension is built so copies share it
+    std::shared_ptr<std::vector<Instruction>> overflow_;
+    std::vector<std::shared_ptr<const ComputeFunction>> custom_functions_;
+    int size_ = 0;
+    int stack_size_ = 0;
+    int max_stack_size_ = 0;
   };
 
   namespace dimension {
@@ -22,8 +22,12 @@
 #pragma once
 
 #include <algorithm>
+#include <cstddef>
 #include <functional>
 #include <memory>
+#include <new>
+#include <typeinfo>
+#include <vector>
 
 namespace visage {
   static constexpr int kUnprintableKeycodeMask = 1 << 30;
@@ -324,6 +328,177 @@ namespace visage {
     return key_code != KeyCode::Unknown && (static_cast<int>(key_code) & kUnprintableKeycodeMask) == 0;
   }
 
+  template<typename T>
+  class Delegate;
+
+  template<typename R, typename... Args>
+  class Delegate<R(Args...)> {
+  public:
+    static constexpr size_t kInlineSize = 2 * sizeof(void*);
+
+    template<typename F>
+    static constexpr bool fitsInline() {
+      return sizeof(F) <= kInlineSize && alignof(F) <= alignof(std::max_align_t) &&
+             std::is_nothrow_move_constructible_v<F>;
+    }
+
+    template<typename F>
+    static bool isEmpty(const F& callable) {
+      if constexpr (std::is_same_v<F, std::nullptr_t>)
+        return true;
+      else if constexpr (std::is_pointer_v<F> || std::is_member_pointer_v<F> ||
+                         std::is_same_v<F, std::function<R(Args...)>>)
+        return callable == nullptr;
+      else
+        return false;
+    }
+
+    Delegate() = default;
+    Delegate(std::nullptr_t) { }
+
+    template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Delegate>>>
+    Delegate(F&& callable) {
+      assign(std::forward<F>(callable));
+    }
+
+    Delegate(const Delegate& other) { copy(other); }
+    Delegate(Delegate&& other) noexcept { move(other); }
+    ~Delegate() { reset(); }
+
+    Delegate& operator=(const Delegate& other) {
+      if (this != &other) {
+        reset();
+        copy(other);
+      }
+      return *this;
+    }
+
+    Delegate& operator=(Delegate&& other) noexcept {
+      if (this != &other) {
+        reset();
+        move(other);
+      }
+      return *this;
+    }
+
+    explicit operator bool() const { return invoke_ != nullptr; }
+
+    R operator()(Args... args) const { return invoke_(storage(), std::forward<Args>(args)...); }
+
+    void reset() {
+      if (manage_)
+        manage_(Operation::Destroy, storage(), nullptr);
+      invoke_ = nullptr;
+      manage_ = nullptr;
+    }
+
+    const std::type_info& targetType() const {
+      if (manage_ == nullptr)
+        return typeid(void);
+      return *manage_(Operation::TargetType, storage(), nullptr);
+    }
+
+  private:
+    enum class Operation {
+      Copy,
+      Move,
+      Destroy,
+      TargetType
+    };
+
+    typedef R (*Invoke)(void*, Args&&...);
+    typedef const std::type_info* (*Manage)(Operation, void*, void*);
+
+    template<typename F>
+    static F* target(void* storage) {
+      if constexpr (fitsInline<F>())
+        return static_cast<F*>(storage);
+      else
+        return *static_cast<F**>(storage);
+    }
+
+    template<typename F>
+    static R invoke(void* storage, Args&&... args) {
+      return (*target<F>(storage))(std::forward<Args>(args)...);
+    }
+
+    template<typename F>
+    static const std::type_info* manage(Operation operation, void* storage, void* source) {
+      switch (operation) {
+      case Operation::Copy:
+        if constexpr (fitsInline<F>())
+          new (storage) F(*target<F>(source));
+        else
+          *static_cast<F**>(storage) = new F(*target<F>(source));
+        return nullptr;
+      case Operation::Move:
+        if constexpr (fitsInline<F>()) {
+          new (storage) F(std::move(*target<F>(source)));
+          target<F>(source)->~F();
+        }
+        else
+          *static_cast<F**>(storage) = target<F>(source);
+        return nullptr;
+      case Operation::Destroy:
+        if constexpr (fitsInline<F>())
+          target<F>(storage)->~F();
+        else
+          delete target<F>(storage);
+        return nullptr;
+      case Operation::TargetType:
+        if constexpr (std::is_same_v<F, std::function<R(Args...)>>)
+          return &target<F>(storage)->target_type();
+        else
+          return &typeid(F);
+      }
+      return nullptr;
+    }
+
+    template<typename F>
+    void assign(F&& callable) {
+      typedef std::decay_t<F> Callable;
+      if (isEmpty(callable))
+        return;
+
+      if constexpr (fitsInline<Callable>())
+        new (storage()) Callable(std::forward<F>(callable));
+      else
+        *static_cast<Callable**>(storage()) = new Callable(std::forward<F>(callable));
+
+      invoke_ = &invoke<Callable>;
+      manage_ = &manage<Callable>;
+    }
+
+    void copy(const Delegate& other) {
+      if (other.manage_)
+        other.manage_(Operation::Copy, storage(), other.storage());
+      invoke_ = other.invoke_;
+      manage_ = other.manage_;
+    }
+
+    void move(Delegate& other) {
+      if (other.manage_)
+        other.manage_(Operation::Move, storage(), other.storage());
+      invoke_ = other.invoke_;
+      manage_ = other.manage_;
+      other.invoke_ = nullptr;
+      other.manage_ = nullptr;
+    }
+
+    void* storage() const { return const_cast<unsigned char*>(storage_); }
+
+    alignas(std::max_align_t) unsigned char storage_[kInlineSize] {};
+    Invoke invoke_ = nullptr;
+    Manage manage_ = nullptr;
+  };
+
+  struct CallbackToken {
+    unsigned int id = 0;
+    int index = -1;
+
+    explicit operator bool() const { return id != 0; }
+  };
+
   template<typename T>
   class CallbackList {
   public:
@@ -335,41 +510,90 @@ namespace visage {
         static_assert(std::is_void_v<R>, "Callback return value must be default constructable");
     }
 
+    template<typename F>
+    using EnableIfCallable = std::enable_if_t<!std::is_same_v<std::decay_t<F>, CallbackList>>;
+
     CallbackList() = default;
-    explicit CallbackList(std::function<T> callback) :
-        original_(std::make_unique<std::function<T>>(callback)) {
-      add(callback);
+
+    template<typename F, typename = EnableIfCallable<F>>
+    explicit CallbackList(F&& callback) {
+      first_.delegate = Delegate<T>(std::forward<F>(callback));
+      has_original_ = static_cast<bool>(first_.delegate);
+      if (has_original_) {
+        first_.id = next_id_++;
+        first_.active = true;
+        size_ = 1;
+      }
     }
-    CallbackList(const CallbackList& other) {
-      if (other.original_)
-        original_ = std::make_unique<std::function<T>>(*other.original_);
-      callbacks_ = other.callbacks_;
+
+    CallbackList(const CallbackList& other) { *this = other; }
+
+    CallbackList& operator=(const CallbackList& other) {
+      if (this == &other)
+        return *this;
+
+      first_ = other.first_;
+      rest_ = other.rest_;
+      size_ = other.size_;
+      num_removed_ = other.num_removed_;
+      next_id_ = other.next_id_;
+      has_original_ = other.has_original_;
+      compact();
+      return *this;
     }
 
-    void add(std::function<T> callback) { callbacks_.push_back(std::move(callback)); }
+    template<typename F, typename = EnableIfCallable<F>>
+    CallbackToken add(F&& callback) {
+      Delegate<T> delegate(std::forward<F>(callback));
+      if (!delegate)
+        return {};
+
+      compact();
+      Entry entry { std::move(delegate), next_id_++, true };
+      CallbackToken token { entry.id, size_ };
+      if (size_ == 0 && !has_original_)
+        first_ = std::move(entry);
+      else
+        rest_.push_back(std::move(entry));
+      size_++;
+      return token;
+    }
 
-    CallbackList& operator+=(std::function<T> callback) {
-      add(callback);
+    template<typename F, typename = EnableIfCallable<F>>
+    CallbackList& operator+=(F&& callback) {
+      add(std::forward<F>(callback));
       return *this;
     }
 
-    void set(std::function<T> callback) {
-      callbacks_.clear();
-      callbacks_.push_back(std::move(callback));
+    template<typename F, typename = EnableIfCallable<F>>
+    CallbackToken set(F&& callback) {
+      clear();
+      return add(std::forward<F>(callback));
     }
 
-    CallbackList& operator=(const std::function<T>& callback) {
-      set(callback);
+    template<typename F, typename = EnableIfCallable<F>>
+    CallbackList& operator=(F&& callback) {
+      set(std::forward<F>(callback));
       return *this;
     }
 
-    void remove(const std::function<T>& callback) {
-      auto compare = [&](const std::function<T>& other) {
-        return other.target_type() == callback.target_type();
-      };
+    bool remove(CallbackToken token) {
+      Entry* entry = find(token);
+      if (entry == nullptr || !entry->active)
+        return false;
+
+      deactivate(*entry);
+      compact();
+      return true;
+    }
 
-      auto it = std::remove_if(callbacks_.begin(), callbacks_.end(), compare);
-      callbacks_.erase(it);
+    void remove(const std::function<T>& callback) {
+      for (int i = 0; i < size_; ++i) {
+        Entry& entry = slot(i);
+        if (entry.active && entry.delegate.targetType() == callback.target_type())
+          deactivate(entry);
+      }
+      compact();
     }
 
     CallbackList& operator-=(const std::function<T>& callback) {
@@ -377,27 +601,125 @@ namespace visage {
       return *this;
     }
 
+    CallbackList& operator-=(CallbackToken token) {
+      remove(token);
+      return *this;
+    }
+
     void reset() {
-      callbacks_.clear();
-      if (original_)
-        callbacks_.push_back(*original_);
+      clear();
+      if (has_original_) {
+        first_.id = next_id_++;
+        first_.active = true;
+        num_removed_--;
+        compact();
+      }
+    }
+
+    void clear() {
+      for (int i = 0; i < size_; ++i) {
+        if (slot(i).active)
+          deactivate(slot(i));
+      }
+      compact();
     }
 
-    void clear() { callbacks_.clear(); }
+    bool empty() const { return numCallbacks() == 0; }
+    int numCallbacks() const { return size_ - num_removed_; }
 
     template<typename... Args>
     auto callback(Args&&... args) {
-      if (callbacks_.empty())
-        return defaultResult<decltype(std::declval<std::function<T>>()(args...))>();
+      typedef decltype(std::declval<Delegate<T>&>()(args...)) Result;
 
-      for (size_t i = 0; i < callbacks_.size() - 1; ++i)
-        callbacks_[i](std::forward<Args>(args)...);
+      int last = size_ - 1;
+      while (last >= 0 && !slot(last).active)
+        last--;
 
-      return callbacks_.back()(std::forward<Args>(args)...);
+      if (last < 0)
+        return defaultResult<Result>();
+
+      DispatchScope scope(this);
+      for (int i = 0; i < last; ++i) {
+        if (slot(i).active)
+          slot(i).delegate(args...);
+      }
+
+      return slot(last).delegate(args...);
     }
 
   private:
-    std::unique_ptr<std::function<T>> original_;
-    std::vector<std::function<T>> callbacks_;
+    struct Entry {
+      Delegate<T> delegate;
+      unsigned int id = 0;
+      bool active = false;
+    };
+
+    struct DispatchScope {
+      explicit DispatchScope(CallbackList* list) : list(list) { list->dispatch_depth_++; }
+      ~DispatchScope() {
+        list->dispatch_depth_--;
+        list->compact();
+      }
+
+      CallbackList* list = nullptr;
+    };
+
+    Entry& slot(int index) { return index == 0 ? first_ : rest_[index - 1]; }
+
+    Entry* find(CallbackToken token) {
+      if (token.id == 0)
+        return nullptr;
+      if (token.index >= 0 && token.index < size_ && slot(token.index).id == token.id)
+        return &slot(token.index);
+
+      int low = 0;
+      int high = size_ - 1;
+      while (low <= high) {
+        int mid = (low + high) / 2;
+        unsigned int id = slot(mid).id;
+        if (id == token.id)
+          return &slot(mid);
+        if (id < token.id)
+          low = mid + 1;
+        else
+          high = mid - 1;
+      }
+      return nullptr;
+    }
+
+    void deactivate(Entry& entry) {
+      entry.active = false;
+      num_removed_++;
+    }
+
+    void compact() {
+      if (dispatch_depth_ > 0 || num_removed_ == 0)
+        return;
+
+      rest_.erase(std::remove_if(rest_.begin(), rest_.end(), [](const Entry& e) { return !e.active; }),
+                  rest_.end());
+      num_removed_ = 0;
+      if (!first_.active && !has_original_) {
+        if (rest_.empty())
+          first_ = {};
+        else {
+          first_ = std::move(rest_.front());
+          rest_.erase(rest_.begin());
+        }
+      }
+      else if (!first_.active)
+        num_removed_ = 1;
+
+      bool first_used = first_.active || has_original_;
+      size_ = rest_.size() + (first_used ? 1 : 0);
+    }
+
+    Entry first_;
+    std::vector<Entry> rest_;
+    int size_ = 0;
+    int num_removed_ = 0;
+    int dispatch_depth_ = 0;
+    unsigned int next_id_ = 1;
+    bool has_original_ = false;
   };
 }
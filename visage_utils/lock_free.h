@@ -0,0 +1,204 @@
+/* Copyright Vital Audio, LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace visage {
+  // Unbounded multi-producer single-consumer queue. push() is wait-free and safe from any
+  // thread, tryPop() and empty() may only be called from the single consumer thread.
+  template<typename T>
+  class MpscQueue {
+  public:
+    MpscQueue() : head_(&stub_), tail_(&stub_) { }
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    ~MpscQueue() {
+      T value;
+      while (tryPop(value)) { }
+      if (tail_ != &stub_)
+        delete tail_;
+    }
+
+    void push(T value) {
+      Node* node = new Node(std::move(value));
+      Node* previous = head_.exchange(node, std::memory_order_acq_rel);
+      previous->next.store(node, std::memory_order_release);
+    }
+
+    bool tryPop(T& result) {
+      Node* tail = tail_;
+      Node* next = tail->next.load(std::memory_order_acquire);
+      if (next == nullptr)
+        return false;
+
+      result = std::move(next->value);
+      tail_ = next;
+      if (tail != &stub_)
+        delete tail;
+      return true;
+    }
+
+    bool empty() const { return tail_->next.load(std::memory_order_acquire) == nullptr; }
+
+  private:
+    struct Node {
+      Node() = default;
+      explicit Node(T&& v) : value(std::move(v)) { }
+
+      std::atomic<Node*> next = nullptr;
+      T value {};
+    };
+
+    Node stub_;
+    std::atomic<Node*> head_;
+    Node* tail_ = nullptr;
+  };
+
+  // Fixed capacity single-producer single-consumer ring buffer. Neither side ever blocks or
+  // allocates, so it's safe to write from a real-time audio thread.
+  template<typename T>
+  class SpscRingBuffer {
+  public:
+    static constexpr int kCacheLineSize = 64;
+
+    explicit SpscRingBuffer(int capacity) {
+      capacity_ = 1;
+      while (capacity_ < capacity)
+        capacity_ *= 2;
+      data_ = std::make_unique<T[]>(capacity_);
+    }
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    int capacity() const { return capacity_; }
+
+    int numAvailable() const {
+      return write_position_.load(std::memory_order_acquire) -
+             read_position_.load(std::memory_order_relaxed);
+    }
+
+    int numFree() const {
+      return capacity_ - (write_position_.load(std::memory_order_relaxed) -
+                          read_position_.load(std::memory_order_acquire));
+    }
+
+    bool push(const T& value) { return write(&value, 1) == 1; }
+    bool pop(T& value) { return read(&value, 1) == 1; }
+
+    int write(const T* data, int num) {
+      unsigned int position = write_position_.load(std::memory_order_relaxed);
+      num = std::min(num, numFree());
+      for (int i = 0; i < num; ++i)
+        data_[(position + i) & (capacity_ - 1)] = data[i];
+
+      write_position_.store(position + num, std::memory_order_release);
+      return num;
+    }
+
+    int read(T* data, int num) {
+      unsigned int position = read_position_.load(std::memory_order_relaxed);
+      num = std::min(num, numAvailable());
+      for (int i = 0; i < num; ++i)
+        data[i] = data_[(position + i) & (capacity_ - 1)];
+
+      read_position_.store(position + num, std::memory_order_release);
+      return num;
+    }
+
+  private:
+    std::unique_ptr<T[]> data_;
+    int capacity_ = 0;
+    alignas(kCacheLineSize) std::atomic<unsigned int> write_position_ = 0;
+    alignas(kCacheLineSize) std::atomic<unsigned int> read_position_ = 0;
+  };
+
+  // Hands the latest complete value from one writer thread to one reader thread. The
+  // writer fills writeBuffer() and calls publish(), the reader calls update() and then
+  // reads readBuffer(). Intermediate values may be skipped but never torn.
+  template<typename T>
+  class TripleBuffer {
+  public:
+    TripleBuffer() = default;
+    explicit TripleBuffer(const T& initial) : buffers_ { initial, initial, initial } { }
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    T& writeBuffer() { return buffers_[write_index_]; }
+
+    void publish() {
+      int previous = middle_.exchange(write_index_ | kNewDataBit);
+      write_index_ = previous & kIndexMask;
+
+      if (reader_waiting_.exchange(false)) {
+        if (auto callback = publish_callback_.load())
+          callback();
+      }
+    }
+
+    bool hasUpdate() const { return middle_.load(std::memory_order_acquire) & kNewDataBit; }
+
+    // Lets a reader stop polling. The next publish() after waitForPublish() calls the publish
+    // callback on the writer thread, so the callback should only signal, e.g. wake an event loop.
+    // Returns true if an update already arrived, in which case there is nothing to wait for.
+    void setPublishCallback(void (*callback)()) { publish_callback_ = callback; }
+
+    bool waitForPublish() {
+      reader_waiting_.store(true);
+      if ((middle_.load() & kNewDataBit) == 0)
+        return false;
+
+      reader_waiting_.store(false);
+      return true;
+    }
+
+    void cancelWaitForPublish() { reader_waiting_.store(false); }
+
+    bool update() {
+      if (!hasUpdate())
+        return false;
+
+      int previous = middle_.exchange(read_index_, std::memory_order_acq_rel);
+      read_index_ = previous & kIndexMask;
+      return true;
+    }
+
+    const T& readBuffer() const { return buffers_[read_index_]; }
+
+  private:
+    static constexpr int kIndexMask = 0x3;
+    static constexpr int kNewDataBit = 0x4;
+
+    T buffers_[3] {};
+    int write_index_ = 0;
+    std::atomic<int> middle_ = 1;
+    int read_index_ = 2;
+    std::atomic<bool> reader_waiting_ = false;
+    std::atomic<void (*)()> publish_callback_ = nullptr;
+  };
+}
@@ -22,6 +22,23 @@
 #include "string_utils.h"
 
 #include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VISAGE_STRING_SSE2 1
+#include <emmintrin.h>
+#if defined(__AVX2__)
+#define VISAGE_STRING_AVX2 1
+#include <immintrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define VISAGE_STRING_NEON 1
+#include <arm_neon.h>
+#endif
 
 namespace visage {
   std::string encodeDataBase64(const char* data, size_t size) {
@@ -89,29 +106,361 @@ namespace visage {
     return result;
   }
 
+  size_t String::widenAscii(const char* utf8, size_t size, void* utf32) {
+    auto dest = static_cast<char*>(utf32);
+    size_t i = 0;
+#if VISAGE_STRING_AVX2
+    for (; i + 32 <= size; i += 32) {
+      __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(utf8 + i));
+      if (_mm256_movemask_epi8(bytes))
+        break;
+
+      for (int offset = 0; offset < 32; offset += 8) {
+        __m128i chunk = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(utf8 + i + offset));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + 4 * (i + offset)),
+                            _mm256_cvtepu8_epi32(chunk));
+      }
+    }
+#endif
+#if VISAGE_STRING_SSE2
+    __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= size; i += 16) {
+      __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(utf8 + i));
+      if (_mm_movemask_epi8(bytes))
+        break;
+
+      __m128i low = _mm_unpacklo_epi8(bytes, zero);
+      __m128i high = _mm_unpackhi_epi8(bytes, zero);
+      auto out = reinterpret_cast<__m128i*>(dest + 4 * i);
+      _mm_storeu_si128(out, _mm_unpacklo_epi16(low, zero));
+      _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(low, zero));
+      _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(high, zero));
+      _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(high, zero));
+    }
+#elif VISAGE_STRING_NEON
+    for (; i + 16 <= size; i += 16) {
+      uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(utf8 + i));
+      if (vmaxvq_u8(bytes) >= 0x80)
+        break;
+
+      uint16x8_t low = vmovl_u8(vget_low_u8(bytes));
+      uint16x8_t high = vmovl_u8(vget_high_u8(bytes));
+      auto out = reinterpret_cast<uint32_t*>(dest + 4 * i);
+      vst1q_u32(out, vmovl_u16(vget_low_u16(low)));
+      vst1q_u32(out + 4, vmovl_u16(vget_high_u16(low)));
+      vst1q_u32(out + 8, vmovl_u16(vget_low_u16(high)));
+      vst1q_u32(out + 12, vmovl_u16(vget_high_u16(high)));
+    }
+#else
+    for (; i + 8 <= size; i += 8) {
+      uint64_t bytes;
+      memcpy(&bytes, utf8 + i, sizeof(bytes));
+      if (bytes & 0x8080808080808080ull)
+        break;
+
+      char32_t characters[8];
+      for (int c = 0; c < 8; ++c)
+        characters[c] = static_cast<unsigned char>(utf8[i + c]);
+      memcpy(dest + 4 * i, characters, sizeof(characters));
+    }
+#endif
+    return i;
+  }
+
+  size_t String::narrowAscii(const void* utf32, size_t size, char* utf8) {
+    auto source = static_cast<const char*>(utf32);
+    size_t i = 0;
+#if VISAGE_STRING_SSE2
+    __m128i ascii_mask = _mm_set1_epi32(~0x7f);
+    for (; i + 16 <= size; i += 16) {
+      auto in = reinterpret_cast<const __m128i*>(source + 4 * i);
+      __m128i a = _mm_loadu_si128(in);
+      __m128i b = _mm_loadu_si128(in + 1);
+      __m128i c = _mm_loadu_si128(in + 2);
+      __m128i d = _mm_loadu_si128(in + 3);
+      __m128i combined = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+      __m128i high_bits = _mm_and_si128(combined, ascii_mask);
+      if (_mm_movemask_epi8(_mm_cmpeq_epi32(high_bits, _mm_setzero_si128())) != 0xffff)
+        break;
+
+      __m128i packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(utf8 + i), packed);
+    }
+#elif VISAGE_STRING_NEON
+    for (; i + 16 <= size; i += 16) {
+      auto in = reinterpret_cast<const uint32_t*>(source + 4 * i);
+      uint32x4_t a = vld1q_u32(in);
+      uint32x4_t b = vld1q_u32(in + 4);
+      uint32x4_t c = vld1q_u32(in + 8);
+      uint32x4_t d = vld1q_u32(in + 12);
+      if (vmaxvq_u32(vorrq_u32(vorrq_u32(a, b), vorrq_u32(c, d))) >= 0x80)
+        break;
+
+      uint16x8_t low = vcombine_u16(vmovn_u32(a), vmovn_u32(b));
+      uint16x8_t high = vcombine_u16(vmovn_u32(c), vmovn_u32(d));
+      vst1q_u8(reinterpret_cast<uint8_t*>(utf8 + i), vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+    }
+#else
+    for (; i + 8 <= size; i += 8) {
+      char32_t characters[8];
+      memcpy(characters, source + 4 * i, sizeof(characters));
+      char32_t combined = 0;
+      for (char32_t character : characters)
+        combined |= character;
+      if (combined >= 0x80)
+        break;
+
+      for (int c = 0; c < 8; ++c)
+        utf8[i + c] = static_cast<char>(characters[c]);
+    }
+#endif
+    return i;
+  }
+
+  size_t String::widenBmp(const void* utf16, size_t size, char32_t* utf32) {
+    auto source = static_cast<const char*>(utf16);
+    size_t i = 0;
+#if VISAGE_STRING_SSE2
+    __m128i zero = _mm_setzero_si128();
+    __m128i surrogate_mask = _mm_set1_epi16(static_cast<short>(0xf800));
+    __m128i surrogate = _mm_set1_epi16(static_cast<short>(0xd800));
+    for (; i + 8 <= size; i += 8) {
+      __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 2 * i));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(units, surrogate_mask), surrogate)))
+        break;
+
+      auto out = reinterpret_cast<__m128i*>(utf32 + i);
+      _mm_storeu_si128(out, _mm_unpacklo_epi16(units, zero));
+      _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(units, zero));
+    }
+#elif VISAGE_STRING_NEON
+    uint16x8_t surrogate_mask = vdupq_n_u16(0xf800);
+    uint16x8_t surrogate = vdupq_n_u16(0xd800);
+    for (; i + 8 <= size; i += 8) {
+      uint16x8_t units = vld1q_u16(reinterpret_cast<const uint16_t*>(source + 2 * i));
+      if (vmaxvq_u16(vceqq_u16(vandq_u16(units, surrogate_mask), surrogate)))
+        break;
+
+      auto out = reinterpret_cast<uint32_t*>(utf32 + i);
+      vst1q_u32(out, vmovl_u16(vget_low_u16(units)));
+      vst1q_u32(out + 4, vmovl_u16(vget_high_u16(units)));
+    }
+#else
+    for (; i + 4 <= size; i += 4) {
+      char16_t units[4];
+      memcpy(units, source + 2 * i, sizeof(units));
+      bool has_surrogate = false;
+      for (char16_t unit : units)
+        has_surrogate = has_surrogate || (unit & 0xf800) == 0xd800;
+      if (has_surrogate)
+        break;
+
+      for (int c = 0; c < 4; ++c)
+        utf32[i + c] = units[c];
+    }
+#endif
+    return i;
+  }
+
+  size_t String::narrowBmp(const char32_t* utf32, size_t size, void* utf16) {
+    auto dest = static_cast<char*>(utf16);
+    size_t i = 0;
+#if VISAGE_STRING_SSE2
+    __m128i zero = _mm_setzero_si128();
+    __m128i surrogate_mask = _mm_set1_epi32(0xf800);
+    __m128i surrogate = _mm_set1_epi32(0xd800);
+    for (; i + 8 <= size; i += 8) {
+      auto in = reinterpret_cast<const __m128i*>(utf32 + i);
+      __m128i a = _mm_loadu_si128(in);
+      __m128i b = _mm_loadu_si128(in + 1);
+      __m128i beyond_bmp = _mm_srli_epi32(_mm_or_si128(a, b), 16);
+      __m128i a_surrogates = _mm_cmpeq_epi32(_mm_and_si128(a, surrogate_mask), surrogate);
+      __m128i b_surrogates = _mm_cmpeq_epi32(_mm_and_si128(b, surrogate_mask), surrogate);
+      if (_mm_movemask_epi8(_mm_cmpeq_epi32(beyond_bmp, zero)) != 0xffff ||
+          _mm_movemask_epi8(_mm_or_si128(a_surrogates, b_surrogates))) {
+        break;
+      }
+
+      a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+      b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 2 * i), _mm_packs_epi32(a, b));
+    }
+#elif VISAGE_STRING_NEON
+    uint32x4_t surrogate_mask = vdupq_n_u32(0xf800);
+    uint32x4_t surrogate = vdupq_n_u32(0xd800);
+    for (; i + 8 <= size; i += 8) {
+      auto in = reinterpret_cast<const uint32_t*>(utf32 + i);
+      uint32x4_t a = vld1q_u32(in);
+      uint32x4_t b = vld1q_u32(in + 4);
+      uint32x4_t surrogates = vorrq_u32(vceqq_u32(vandq_u32(a, surrogate_mask), surrogate),
+                                        vceqq_u32(vandq_u32(b, surrogate_mask), surrogate));
+      if (vmaxvq_u32(vorrq_u32(a, b)) > 0xffff || vmaxvq_u32(surrogates))
+        break;
+
+      uint16x8_t units = vcombine_u16(vmovn_u32(a), vmovn_u32(b));
+      vst1q_u16(reinterpret_cast<uint16_t*>(dest + 2 * i), units);
+    }
+#else
+    for (; i + 4 <= size; i += 4) {
+      bool bmp = true;
+      for (int c = 0; c < 4; ++c)
+        bmp = bmp && utf32[i + c] <= 0xffff && (utf32[i + c] & 0xf800) != 0xd800;
+      if (!bmp)
+        break;
+
+      char16_t units[4];
+      for (int c = 0; c < 4; ++c)
+        units[c] = static_cast<char16_t>(utf32[i + c]);
+      memcpy(dest + 2 * i, units, sizeof(units));
+    }
+#endif
+    return i;
+  }
+
+  void String::setUtf8(const std::string& string) {
+    auto is_ascii = [](char character) { return (character & 0x80) == 0; };
+    if (std::all_of(string.begin(), string.end(), is_ascii))
+      string_.emplace<std::string>(string);
+    else
+      setUtf32(convertToUtf32(string));
+  }
+
+  void String::setDecimal(double value, int precision, bool trim_zeros) {
+    // Formats like std::to_string() to six decimal places, then rounds the text to the
+    // precision the way withPrecision() does, all within a stack buffer
+    static constexpr int kMaxPrecision = 64;
+    char buffer[400];
+    char* start = buffer + 1;
+    char* end = buffer + sizeof(buffer) - kMaxPrecision;
+    precision = std::max(0, std::min(precision, kMaxPrecision));
+
+#if __cpp_lib_to_chars
+    std::to_chars_result result = std::to_chars(start, end, value, std::chars_format::fixed,
+                                                kDefaultDecimalPlaces);
+    size_t length = result.ptr - start;
+#else
+    size_t length = std::max(0, snprintf(start, end - start, "%.*f", kDefaultDecimalPlaces, value));
+#endif
+
+    char* dot = std::find(start, start + length, '.');
+    if (dot != start + length && trim_zeros) {
+      while (start[length - 1] == '0')
+        --length;
+      if (start[length - 1] == '.')
+        --length;
+    }
+    else if (dot != start + length) {
+      size_t pos = (dot - start) + precision + 1;
+      if (pos < length) {
+        size_t rounded_length = start[pos - 1] == '.' ? pos - 1 : pos;
+        bool carry = start[pos] >= '5';
+        while (pos > 0 && carry) {
+          --pos;
+          if (start[pos] == '9')
+            start[pos] = '0';
+          else if (start[pos] != '.' && start[pos] != '-') {
+            ++start[pos];
+            carry = false;
+          }
+        }
+
+        length = rounded_length;
+        if (carry) {
+          --start;
+          ++length;
+          if (start[1] == '-') {
+            start[0] = '-';
+            start[1] = '1';
+          }
+          else
+            start[0] = '1';
+        }
+      }
+      else {
+        std::fill(start + length, start + pos, '0');
+        length = pos;
+      }
+    }
+
+    string_.emplace<std::string>(start, length);
+  }
+
+  String String::shortest(float value) {
+    char buffer[32];
+#if __cpp_lib_to_chars
+    char* end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+#else
+    char* end = buffer;
+    for (int precision = 1; precision <= 9; ++precision) {
+      end = buffer + std::max(0, snprintf(buffer, sizeof(buffer), "%.*g", precision, value));
+      if (strtof(buffer, nullptr) == value)
+        break;
+    }
+#endif
+    String result;
+    result.string_.emplace<std::string>(buffer, end);
+    return result;
+  }
+
+  String String::shortest(double value) {
+    char buffer[32];
+#if __cpp_lib_to_chars
+    char* end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+#else
+    char* end = buffer;
+    for (int precision = 1; precision <= 17; ++precision) {
+      end = buffer + std::max(0, snprintf(buffer, sizeof(buffer), "%.*g", precision, value));
+      if (strtod(buffer, nullptr) == value)
+        break;
+    }
+#endif
+    String result;
+    result.string_.emplace<std::string>(buffer, end);
+    return result;
+  }
+
+  std::string String::toUtf8() const {
+    const std::string* latin1 = std::get_if<std::string>(&string_);
+    if (latin1 == nullptr)
+      return convertToUtf8(toUtf32());
+
+    std::string result;
+    result.reserve(latin1->size());
+    for (char character : *latin1) {
+      unsigned char value = character;
+      if (value < 0x80)
+        result.push_back(character);
+      else {
+        result.push_back(static_cast<char>((value >> 6) | 0xC0));
+        result.push_back(static_cast<char>((value & 0x3F) | 0x80));
+      }
+    }
+    return result;
+  }
+
   String String::toLower() const {
-    std::u32string result = string_;
+    std::u32string result = toUtf32();
     std::transform(result.begin(), result.end(), result.begin(), ::tolower);
     return result;
   }
 
   String String::toUpper() const {
-    std::u32string result = string_;
+    std::u32string result = toUtf32();
     std::transform(result.begin(), result.end(), result.begin(), ::toupper);
     return result;
   }
 
   String String::removeCharacters(const std::string& characters) const {
-    std::u32string result = string_;
+    std::u32string result = toUtf32();
     auto filter = [&characters](char32_t c) { return characters.find(c) != std::string::npos; };
     result.erase(std::remove_if(result.begin(), result.end(), filter), result.end());
     return result;
   }
 
   String String::removeEmojiVariations() const {
-    std::u32string result = string_;
+    std::u32string result = toUtf32();
     auto filter = [](char32_t c) { return (c & 0xfffffff0) == 0xfe00; };
     result.erase(std::remove_if(result.begin(), result.end(), filter), result.end());
     return result;
   }
-}
\ No newline at end of file
+}
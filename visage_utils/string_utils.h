@@ -21,133 +21,186 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <charconv>
 #include <memory>
 #include <string>
+#include <variant>
 
 namespace visage {
   class String {
   public:
     template<typename Utf32String>
     static Utf32String convertUtf8ToUtf32(const std::string& utf8_str) {
+      constexpr bool kFastPath = sizeof(typename Utf32String::value_type) == sizeof(char32_t);
       Utf32String result;
-      result.reserve(utf8_str.size());
+      result.resize(utf8_str.size());
+      size_t length = 0;
 
       for (size_t i = 0; i < utf8_str.size(); ++i) {
         unsigned char ch = utf8_str[i];
 
-        if (ch < 0x80)  // ASCII character
-          result.push_back(ch);
+        if (ch < 0x80) {  // ASCII character
+          size_t ascii = 0;
+          if constexpr (kFastPath)
+            ascii = widenAscii(utf8_str.data() + i, utf8_str.size() - i, result.data() + length);
+          if (ascii) {
+            length += ascii;
+            i += ascii - 1;
+          }
+          else
+            result[length++] = ch;
+        }
         else if (ch < 0xC0)  // Error on continuation byte
-          result.push_back('*');
+          result[length++] = '*';
         else if (ch < 0xE0) {  // 2 byte character
           if (i + 1 >= utf8_str.size())  // Error - unfinished character.
-            return result;
+            break;
 
-          result.push_back(((ch & 0x1F) << 6) | (utf8_str[i + 1] & 0x3F));
+          result[length++] = ((ch & 0x1F) << 6) | (utf8_str[i + 1] & 0x3F);
           i += 1;
         }
         else if (ch < 0xF0) {  // 3 byte character
           if (i + 2 >= utf8_str.size())  // Error - unfinished character.
-            return result;
+            break;
 
-          result.push_back(((ch & 0x0F) << 12) | ((utf8_str[i + 1] & 0x3F) << 6) |
-                           (utf8_str[i + 2] & 0x3F));
+          result[length++] = ((ch & 0x0F) << 12) | ((utf8_str[i + 1] & 0x3F) << 6) |
+                             (utf8_str[i + 2] & 0x3F);
           i += 2;
         }
         else if (ch < 0xF8) {  // 4 byte character
           if (i + 3 >= utf8_str.size())  // Error - unfinished character.
-            return result;
+            break;
 
-          result.push_back(((ch & 0x07) << 18) | ((utf8_str[i + 1] & 0x3F) << 12) |
-                           ((utf8_str[i + 2] & 0x3F) << 6) | (utf8_str[i + 3] & 0x3F));
+          result[length++] = ((ch & 0x07) << 18) | ((utf8_str[i + 1] & 0x3F) << 12) |
+                             ((utf8_str[i + 2] & 0x3F) << 6) | (utf8_str[i + 3] & 0x3F);
           i += 3;
         }
         else  // Error
-          return result;
+          break;
       }
 
+      result.resize(length);
       return result;
     }
 
     template<typename Utf32String>
     static std::string convertUtf32ToUtf8(const Utf32String& utf32_str) {
+      constexpr bool kFastPath = sizeof(typename Utf32String::value_type) == sizeof(char32_t);
       std::string result;
-      result.reserve(utf32_str.size() * 4);
-
-      for (auto character : utf32_str) {
-        if (character < 0x80)  // ASCII character
-          result.push_back(static_cast<char>(character));
+      result.resize(utf32_str.size() * 4);
+      size_t length = 0;
+
+      for (size_t i = 0; i < utf32_str.size(); ++i) {
+        char32_t character = utf32_str[i];
+        if (character < 0x80) {  // ASCII character
+          size_t ascii = 0;
+          if constexpr (kFastPath)
+            ascii = narrowAscii(utf32_str.data() + i, utf32_str.size() - i, result.data() + length);
+          if (ascii) {
+            length += ascii;
+            i += ascii - 1;
+          }
+          else
+            result[length++] = static_cast<char>(character);
+        }
         else if (character < 0x800) {  // 2 byte character
-          result.push_back(static_cast<char>((character >> 6) | 0xC0));
-          result.push_back(static_cast<char>((character & 0x3F) | 0x80));
+          result[length++] = static_cast<char>((character >> 6) | 0xC0);
+          result[length++] = static_cast<char>((character & 0x3F) | 0x80);
         }
         else if (character < 0x10000) {  // 3 byte character
-          result.push_back(static_cast<char>((character >> 12) | 0xE0));
-          result.push_back(static_cast<char>(((character >> 6) & 0x3F) | 0x80));
-          result.push_back(static_cast<char>((character & 0x3F) | 0x80));
+          result[length++] = static_cast<char>((character >> 12) | 0xE0);
+          result[length++] = static_cast<char>(((character >> 6) & 0x3F) | 0x80);
+          result[length++] = static_cast<char>((character & 0x3F) | 0x80);
         }
         else if (character < 0x110000) {  // 4 byte character
-          result.push_back(static_cast<char>((character >> 18) | 0xF0));
-          result.push_back(static_cast<char>(((character >> 12) & 0x3F) | 0x80));
-          result.push_back(static_cast<char>(((character >> 6) & 0x3F) | 0x80));
-          result.push_back(static_cast<char>((character & 0x3F) | 0x80));
+          result[length++] = static_cast<char>((character >> 18) | 0xF0);
+          result[length++] = static_cast<char>(((character >> 12) & 0x3F) | 0x80);
+          result[length++] = static_cast<char>(((character >> 6) & 0x3F) | 0x80);
+          result[length++] = static_cast<char>((character & 0x3F) | 0x80);
         }
         else  // Error
-          return result;
+          break;
       }
+
+      result.resize(length);
       return result;
     }
 
     template<typename T>
     static T convertUtf32ToUtf16(const std::u32string& utf32_str) {
+      constexpr bool kFastPath = sizeof(typename T::value_type) == sizeof(char16_t);
       T result;
-      result.reserve(utf32_str.size());
+      result.resize(utf32_str.size() * 2);
+      size_t length = 0;
 
-      for (char32_t character : utf32_str) {
+      for (size_t i = 0; i < utf32_str.size(); ++i) {
+        char32_t character = utf32_str[i];
         if (character <= 0xFFFF) {
           if (character >= 0xD800 && character <= 0xDFFF)  // Error
-            return result;
-          result.push_back(static_cast<char16_t>(character));
+            break;
+
+          size_t bmp = 0;
+          if constexpr (kFastPath)
+            bmp = narrowBmp(utf32_str.data() + i, utf32_str.size() - i, result.data() + length);
+          if (bmp) {
+            length += bmp;
+            i += bmp - 1;
+          }
+          else
+            result[length++] = static_cast<char16_t>(character);
         }
         else if (character <= 0x10FFFF) {
           character -= 0x10000;
-          auto high_surrogate = static_cast<char16_t>((character >> 10) + 0xD800);
-          auto low_surrogate = static_cast<char16_t>((character & 0x3FF) + 0xDC00);
-          result.push_back(high_surrogate);
-          result.push_back(low_surrogate);
+          result[length++] = static_cast<char16_t>((character >> 10) + 0xD800);
+          result[length++] = static_cast<char16_t>((character & 0x3FF) + 0xDC00);
         }
         else  // Error
-          return result;
+          break;
       }
+
+      result.resize(length);
       return result;
     }
 
     template<typename T>
     static std::u32string convertUtf16ToUtf32(const T& utf16_str) {
+      constexpr bool kFastPath = sizeof(typename T::value_type) == sizeof(char16_t);
       std::u32string result;
-      result.reserve(utf16_str.size());
+      result.resize(utf16_str.size());
+      size_t length = 0;
 
       for (size_t i = 0; i < utf16_str.size(); ++i) {
         char16_t ch = utf16_str[i];
 
         if (ch >= 0xD800 && ch <= 0xDBFF) {  // 4 byte character
           if (i + 1 >= utf16_str.size())  // Error - unfinished character
-            return result;
+            break;
 
           char16_t low_surrogate = utf16_str[++i];
 
           if (low_surrogate < 0xDC00 || low_surrogate > 0xDFFF)  // Error - bad low surrogate
-            return result;
+            break;
 
-          char32_t character = 0x10000 + ((ch - 0xD800) << 10) + (low_surrogate - 0xDC00);
-          result.push_back(character);
+          result[length++] = 0x10000 + ((ch - 0xD800) << 10) + (low_surrogate - 0xDC00);
         }
         else if (ch >= 0xDC00 && ch <= 0xDFFF)  // Error - missing high surrogate
-          return result;
-        else  // 2 byte character
-          result.push_back(static_cast<char32_t>(ch));
+          break;
+        else {  // 2 byte character
+          size_t bmp = 0;
+          if constexpr (kFastPath)
+            bmp = widenBmp(utf16_str.data() + i, utf16_str.size() - i, result.data() + length);
+          if (bmp) {
+            length += bmp;
+            i += bmp - 1;
+          }
+          else
+            result[length++] = static_cast<char32_t>(ch);
+        }
       }
 
+      result.resize(length);
       return result;
     }
 
@@ -186,81 +239,101 @@ namespace visage {
 
     String() = default;
 
-    String(std::u32string string) : string_(std::move(string)) { }
-    String(const std::string& string) : string_(convertToUtf32(string)) { }
-    String(const std::wstring& string) : string_(convertToUtf32(string)) { }
-    String(const char32_t* string) : string_(string) { }
-    String(const wchar_t* string) : string_(convertToUtf32(string)) { }
-    String(const char* string) : string_(convertToUtf32(string)) { }
+    String(std::u32string string) { setUtf32(std::move(string)); }
+    String(const std::string& string) { setUtf8(string); }
+    String(const std::wstring& string) : String(convertToUtf32(string)) { }
+    String(const char32_t* string) {
+      setCharacters(string, std::char_traits<char32_t>::length(string));
+    }
+    String(const wchar_t* string) : String(std::wstring(string)) { }
+    String(const char* string) : String(std::string(string)) { }
 
     String(const visage::String& other) = default;
 
     explicit String(bool value) : String(value ? U"true" : U"false") { }
-    String(char32_t character) { string_.push_back(character); }
-    String(char character) {
-      std::string tmp;
-      tmp.push_back(character);
-      string_ = convertToUtf32(tmp);
-    }
-
-    String(int value) : String(std::to_string(value)) { }
-    String(unsigned int value) : String(std::to_string(value)) { }
-    String(long value) : String(std::to_string(value)) { }
-    String(unsigned long value) : String(std::to_string(value)) { }
-    String(long long value) : String(std::to_string(value)) { }
-    String(unsigned long long value) : String(std::to_string(value)) { }
-    String(float value) : String(std::to_string(value)) { removeTrailingZeros(); }
-    String(float value, int precision) : String(std::to_string(value)) {
-      *this = withPrecision(precision);
-    }
-
-    String(double value) : String(std::to_string(value)) { removeTrailingZeros(); }
-    String(double value, int precision) : String(std::to_string(value)) {
-      *this = withPrecision(precision);
-    }
+    String(char32_t character) { setCharacters(&character, 1); }
+    String(char character) : String(std::string(1, character)) { }
+
+    String(int value) { setInteger(value); }
+    String(unsigned int value) { setInteger(value); }
+    String(long value) { setInteger(value); }
+    String(unsigned long value) { setInteger(value); }
+    String(long long value) { setInteger(value); }
+    String(unsigned long long value) { setInteger(value); }
+    String(float value) { setDecimal(value, kDefaultDecimalPlaces, true); }
+    String(float value, int precision) { setDecimal(value, precision, false); }
+    String(double value) { setDecimal(value, kDefaultDecimalPlaces, true); }
+    String(double value, int precision) { setDecimal(value, precision, false); }
+
+    // Shortest text that parses back to exactly the same value
+    static String shortest(float value);
+    static String shortest(double value);
 
     String withPrecision(int precision) const {
-      size_t pos = find('.');
+      std::u32string string = toUtf32();
+      size_t pos = string.find('.');
 
       if (pos == std::string::npos)
-        return string_;
+        return string;
 
       pos += precision + 1;
-      if (pos < string_.length()) {
-        std::u32string result = string_.substr(0, string_[pos - 1] == '.' ? pos - 1 : pos);
-        bool carry = string_[pos] >= '5';
+      if (pos < string.length()) {
+        std::u32string result = string.substr(0, string[pos - 1] == '.' ? pos - 1 : pos);
+        bool carry = string[pos] >= '5';
         while (pos > 0 && carry) {
           --pos;
-          if (string_[pos] == '9')
+          if (string[pos] == '9')
             result[pos] = '0';
-          else if (string_[pos] != '.') {
+          else if (string[pos] != '.' && string[pos] != '-') {
             ++result[pos];
             carry = false;
           }
         }
         if (carry)
-          return U"1" + result;
+          return result.insert(result[0] == '-' ? 1 : 0, 1, '1');
 
         return result;
       }
 
-      return string_ + std::u32string(pos - string_.length(), '0');
+      return string + std::u32string(pos - string.length(), '0');
     }
 
-    std::wstring toWide() const { return convertToWide(string_); }
-    std::string toUtf8() const { return convertToUtf8(string_); }
-    std::u32string toUtf32() const { return string_; }
-
-    void removeTrailingZeros() {
-      size_t pos = find('.');
+    std::wstring toWide() const { return convertToWide(toUtf32()); }
+    std::string toUtf8() const;
+    std::u32string toUtf32() const {
+      return visitCharacters([](auto* characters, size_t size) {
+        return convertCharacters<std::u32string>(characters, size);
+      });
+    }
 
-      if (pos != std::string::npos) {
-        while (string_.back() == '0')
-          string_.pop_back();
+    // Calls function with a pointer to the stored characters and their count. The pointer is to
+    // unsigned char, char16_t or char32_t depending on the widest character in the string.
+    template<typename F>
+    auto visitCharacters(F&& function) const
+        -> decltype(function(static_cast<const char32_t*>(nullptr), size_t(0))) {
+      if (auto latin1 = std::get_if<std::string>(&string_))
+        return function(reinterpret_cast<const unsigned char*>(latin1->data()), latin1->size());
+      if (auto ucs2 = std::get_if<std::u16string>(&string_))
+        return function(ucs2->data(), ucs2->size());
+
+      const std::u32string& utf32 = std::get<std::u32string>(string_);
+      return function(utf32.data(), utf32.size());
+    }
 
-        if (string_.back() == '.')
-          string_.pop_back();
-      }
+    void removeTrailingZeros() {
+      std::visit(
+          [](auto& string) {
+            if (string.find('.') == std::string::npos)
+              return;
+
+            while (string.back() == '0')
+              string.pop_back();
+
+            if (string.back() == '.')
+              string.pop_back();
+          },
+          string_);
+      utf32_cache_.reset();
     }
 
     String toLower() const;
@@ -287,110 +360,313 @@ namespace visage {
     }
 
     bool endsWith(const std::u32string& suffix) const {
-      return string_.size() >= suffix.size() &&
-             0 == string_.compare(string_.size() - suffix.size(), suffix.size(), suffix);
+      size_t string_length = length();
+      if (string_length < suffix.size())
+        return false;
+
+      size_t start = string_length - suffix.size();
+      for (size_t i = 0; i < suffix.size(); ++i) {
+        if ((*this)[start + i] != suffix[i])
+          return false;
+      }
+      return true;
     }
 
     bool endsWith(const std::string& suffix) const { return endsWith(convertToUtf32(suffix)); }
-    bool endsWith(char suffix) const { return !string_.empty() && string_.back() == suffix; }
+    bool endsWith(char suffix) const {
+      return !isEmpty() && (*this)[length() - 1] == static_cast<unsigned char>(suffix);
+    }
 
     bool contains(const std::u32string& substring) const {
-      return string_.find(substring) != std::string::npos;
+      return visitCharacters([&substring](auto* characters, size_t size) {
+        auto end = characters + size;
+        auto equal = [](auto character, char32_t other) { return character == other; };
+        return std::search(characters, end, substring.begin(), substring.end(), equal) != end ||
+               substring.empty();
+      });
     }
 
     bool contains(const std::string& substring) const {
       return contains(convertToUtf32(substring));
     }
 
-    std::u32string::iterator begin() { return string_.begin(); }
+    // Mutable iteration needs UTF-32 storage so this widens the string in place
+    std::u32string::iterator begin() {
+      utf32_cache_.reset();
+      if (string_.index() != kUtf32)
+        string_ = toUtf32();
+      return std::get<std::u32string>(string_).begin();
+    }
 
-    visage::String operator+(const visage::String& other) const { return string_ + other.string_; }
-    visage::String operator+(const std::u32string& other) const { return string_ + other; }
-    visage::String operator+(const std::string& other) const {
-      return string_ + convertToUtf32(other);
+    visage::String operator+(const visage::String& other) const {
+      visage::String result = *this;
+      result += other;
+      return result;
     }
-    visage::String operator+(const char32_t* other) const { return string_ + other; }
-    visage::String operator+(const char* other) const { return string_ + convertToUtf32(other); }
+    visage::String operator+(const std::u32string& other) const {
+      visage::String result = *this;
+      result += other;
+      return result;
+    }
+    visage::String operator+(const std::string& other) const { return *this + String(other); }
+    visage::String operator+(const char32_t* other) const { return *this + String(other); }
+    visage::String operator+(const char* other) const { return *this + String(other); }
     visage::String& operator+=(const visage::String& other) {
-      string_ += other.string_;
+      if (&other == this)
+        return *this += visage::String(other);
+
+      other.visitCharacters([this](auto* characters, size_t size) { append(characters, size); });
       return *this;
     }
 
     visage::String& operator+=(const std::u32string& other) {
-      string_ += other;
+      append(other.data(), other.size());
       return *this;
     }
 
-    visage::String& operator+=(const std::string& other) {
-      string_ += convertToUtf32(other);
-      return *this;
+    visage::String& operator+=(const std::string& other) { return *this += String(other); }
+    visage::String& operator+=(const char32_t* other) { return *this += String(other); }
+    visage::String& operator+=(const char* other) { return *this += String(other); }
+
+    bool operator==(const visage::String& other) const { return compare(other) == 0; }
+    bool operator==(const std::u32string& other) const { return compare(other) == 0; }
+    bool operator==(const std::string& other) const { return compare(String(other)) == 0; }
+    bool operator==(const char32_t* other) const { return compare(other) == 0; }
+    bool operator==(const char* other) const { return compare(String(other)) == 0; }
+    bool operator!=(const visage::String& other) const { return compare(other) != 0; }
+    bool operator!=(const std::u32string& other) const { return compare(other) != 0; }
+    bool operator!=(const std::string& other) const { return compare(String(other)) != 0; }
+    bool operator!=(const char32_t* other) const { return compare(other) != 0; }
+    bool operator!=(const char* other) const { return compare(String(other)) != 0; }
+    bool operator<(const visage::String& other) const { return compare(other) < 0; }
+    bool operator<(const std::u32string& other) const { return compare(other) < 0; }
+    bool operator<(const std::string& other) const { return compare(String(other)) < 0; }
+    bool operator<(const char32_t* other) const { return compare(other) < 0; }
+    bool operator<(const char* other) const { return compare(String(other)) < 0; }
+    bool operator<=(const visage::String& other) const { return compare(other) <= 0; }
+    bool operator<=(const std::u32string& other) const { return compare(other) <= 0; }
+    bool operator<=(const std::string& other) const { return compare(String(other)) <= 0; }
+    bool operator<=(const char32_t* other) const { return compare(other) <= 0; }
+    bool operator<=(const char* other) const { return compare(String(other)) <= 0; }
+    bool operator>(const visage::String& other) const { return compare(other) > 0; }
+    bool operator>(const std::u32string& other) const { return compare(other) > 0; }
+    bool operator>(const std::string& other) const { return compare(String(other)) > 0; }
+    bool operator>(const char32_t* other) const { return compare(other) > 0; }
+    bool operator>(const char* other) const { return compare(String(other)) > 0; }
+    bool operator>=(const visage::String& other) const { return compare(other) >= 0; }
+    bool operator>=(const std::u32string& other) const { return compare(other) >= 0; }
+    bool operator>=(const std::string& other) const { return compare(String(other)) >= 0; }
+    bool operator>=(const char32_t* other) const { return compare(other) >= 0; }
+    bool operator>=(const char* other) const { return compare(String(other)) >= 0; }
+
+    int find(char32_t character) const {
+      return visitCharacters([character](auto* characters, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+          if (characters[i] == character)
+            return static_cast<int>(i);
+        }
+        return -1;
+      });
     }
-
-    visage::String& operator+=(const char32_t* other) {
-      string_ += other;
-      return *this;
+    char32_t operator[](size_t index) const {
+      return visitCharacters([index](auto* characters, size_t) -> char32_t {
+        return characters[index];
+      });
     }
-
-    visage::String& operator+=(const char* other) {
-      string_ += convertToUtf32(other);
-      return *this;
+    // Compact strings hand out a UTF-32 copy built on first use. Prefer visitCharacters or
+    // toUtf32 where possible to avoid keeping the copy alive.
+    const char32_t* c_str() const {
+      if (auto utf32 = std::get_if<std::u32string>(&string_))
+        return utf32->c_str();
+      return utf32_cache_.get([this] { return toUtf32(); }).c_str();
     }
-
-    bool operator==(const visage::String& other) const { return string_ == other.string_; }
-    bool operator==(const std::u32string& other) const { return string_ == other; }
-    bool operator==(const std::string& other) const { return string_ == convertToUtf32(other); }
-    bool operator==(const char32_t* other) const { return string_ == other; }
-    bool operator==(const char* other) const { return string_ == convertToUtf32(other); }
-    bool operator!=(const visage::String& other) const { return string_ != other.string_; }
-    bool operator!=(const std::u32string& other) const { return string_ != other; }
-    bool operator!=(const std::string& other) const { return string_ != convertToUtf32(other); }
-    bool operator!=(const char32_t* other) const { return string_ != other; }
-    bool operator!=(const char* other) const { return string_ != convertToUtf32(other); }
-    bool operator<(const visage::String& other) const { return string_ < other.string_; }
-    bool operator<(const std::u32string& other) const { return string_ < other; }
-    bool operator<(const std::string& other) const { return string_ < convertToUtf32(other); }
-    bool operator<(const char32_t* other) const { return string_ < other; }
-    bool operator<(const char* other) const { return string_ < convertToUtf32(other); }
-    bool operator<=(const visage::String& other) const { return string_ <= other.string_; }
-    bool operator<=(const std::u32string& other) const { return string_ <= other; }
-    bool operator<=(const std::string& other) const { return string_ <= convertToUtf32(other); }
-    bool operator<=(const char32_t* other) const { return string_ <= other; }
-    bool operator<=(const char* other) const { return string_ <= convertToUtf32(other); }
-    bool operator>(const visage::String& other) const { return string_ > other.string_; }
-    bool operator>(const std::u32string& other) const { return string_ > other; }
-    bool operator>(const std::string& other) const { return string_ > convertToUtf32(other); }
-    bool operator>(const char32_t* other) const { return string_ > other; }
-    bool operator>(const char* other) const { return string_ > convertToUtf32(other); }
-    bool operator>=(const visage::String& other) const { return string_ >= other.string_; }
-    bool operator>=(const std::u32string& other) const { return string_ >= other; }
-    bool operator>=(const std::string& other) const { return string_ >= convertToUtf32(other); }
-    bool operator>=(const char32_t* other) const { return string_ >= other; }
-    bool operator>=(const char* other) const { return string_ >= convertToUtf32(other); }
-
-    int find(char32_t character) const { return string_.find(character); }
-    char32_t operator[](size_t index) const { return string_[index]; }
-    const char32_t* c_str() const { return string_.c_str(); }
-    size_t length() const { return string_.length(); }
-    size_t size() const { return string_.size(); }
-    void clear() { string_.clear(); }
-    bool isEmpty() const { return string_.empty(); }
+    size_t length() const {
+      return visitCharacters([](auto*, size_t size) { return size; });
+    }
+    size_t size() const { return length(); }
+    void clear() {
+      string_ = std::string();
+      utf32_cache_.reset();
+    }
+    bool isEmpty() const { return length() == 0; }
 
     visage::String substring(size_t position = 0, size_t count = std::string::npos) const {
-      return string_.substr(position, count);
+      return std::visit(
+          [position, count](const auto& string) {
+            visage::String result;
+            result.string_ = string.substr(position, count);
+            return result;
+          },
+          string_);
     }
 
     visage::String trim() const {
-      size_t start = string_.find_first_not_of(U" \t\n\r");
-      size_t end = string_.find_last_not_of(U" \t\n\r");
-
-      if (start == std::string::npos || end == std::string::npos)
+      auto is_space = [](char32_t character) {
+        return character == ' ' || character == '\t' || character == '\n' || character == '\r';
+      };
+
+      size_t start = 0;
+      size_t end = length();
+      while (start < end && is_space((*this)[start]))
+        ++start;
+      while (end > start && is_space((*this)[end - 1]))
+        --end;
+
+      if (start == end)
         return "";
 
-      return string_.substr(start, end - start + 1);
+      return substring(start, end - start);
     }
 
   private:
-    std::u32string string_;
+    // Vectorised fast paths for the converters. Each transcodes the leading whole blocks of
+    // characters that map one to one and returns how many it wrote, possibly none.
+    static size_t widenAscii(const char* utf8, size_t size, void* utf32);
+    static size_t narrowAscii(const void* utf32, size_t size, char* utf8);
+    static size_t widenBmp(const void* utf16, size_t size, char32_t* utf32);
+    static size_t narrowBmp(const char32_t* utf32, size_t size, void* utf16);
+
+    // Each string is stored as Latin-1, UCS-2 or UTF-32, whichever is the narrowest that fits
+    enum Representation {
+      kLatin1,
+      kUcs2,
+      kUtf32
+    };
+    using Storage = std::variant<std::string, std::u16string, std::u32string>;
+
+    static Representation representation(char32_t max_character) {
+      if (max_character <= 0xff)
+        return kLatin1;
+      if (max_character <= 0xffff)
+        return kUcs2;
+      return kUtf32;
+    }
+
+    template<typename T>
+    static char32_t maxCharacter(const T* characters, size_t size) {
+      char32_t max_character = 0;
+      for (size_t i = 0; i < size; ++i)
+        max_character = std::max<char32_t>(max_character, characters[i]);
+      return max_character;
+    }
+
+    template<typename S, typename T>
+    static S convertCharacters(const T* characters, size_t size) {
+      S result(size, 0);
+      for (size_t i = 0; i < size; ++i)
+        result[i] = static_cast<typename S::value_type>(characters[i]);
+      return result;
+    }
+
+    template<typename T>
+    void setCharacters(const T* characters, size_t size) {
+      switch (representation(maxCharacter(characters, size))) {
+      case kLatin1: string_ = convertCharacters<std::string>(characters, size); break;
+      case kUcs2: string_ = convertCharacters<std::u16string>(characters, size); break;
+      case kUtf32: string_ = convertCharacters<std::u32string>(characters, size); break;
+      }
+    }
+
+    void setUtf32(std::u32string string) {
+      if (representation(maxCharacter(string.data(), string.size())) == kUtf32)
+        string_ = std::move(string);
+      else
+        setCharacters(string.data(), string.size());
+    }
+
+    void setUtf8(const std::string& string);
+
+    static constexpr int kDefaultDecimalPlaces = 6;
+
+    template<typename T>
+    void setInteger(T value) {
+      char buffer[24];
+      std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+      string_.emplace<std::string>(buffer, result.ptr);
+    }
+
+    void setDecimal(double value, int precision, bool trim_zeros);
+
+    template<typename T>
+    void append(const T* characters, size_t size) {
+      utf32_cache_.reset();
+      Representation needed = representation(maxCharacter(characters, size));
+      if (needed > string_.index()) {
+        string_ = visitCharacters([needed](auto* existing, size_t existing_size) -> Storage {
+          if (needed == kUcs2)
+            return convertCharacters<std::u16string>(existing, existing_size);
+          return convertCharacters<std::u32string>(existing, existing_size);
+        });
+      }
+
+      std::visit(
+          [characters, size](auto& string) {
+            using Character = typename std::decay_t<decltype(string)>::value_type;
+            size_t start = string.size();
+            string.resize(start + size);
+            for (size_t i = 0; i < size; ++i)
+              string[start + i] = static_cast<Character>(characters[i]);
+          },
+          string_);
+    }
+
+    template<typename T>
+    int compareCharacters(const T* other, size_t other_size) const {
+      return visitCharacters([other, other_size](auto* characters, size_t size) {
+        size_t common = std::min(size, other_size);
+        for (size_t i = 0; i < common; ++i) {
+          char32_t character = characters[i];
+          char32_t other_character = other[i];
+          if (character != other_character)
+            return character < other_character ? -1 : 1;
+        }
+        return size < other_size ? -1 : (size > other_size ? 1 : 0);
+      });
+    }
+
+    int compare(const visage::String& other) const {
+      return other.visitCharacters([this](auto* characters, size_t size) {
+        return compareCharacters(characters, size);
+      });
+    }
+    int compare(const std::u32string& other) const {
+      return compareCharacters(other.data(), other.size());
+    }
+    int compare(const char32_t* other) const {
+      return compareCharacters(other, std::char_traits<char32_t>::length(other));
+    }
+
+    // Copies start empty so each string builds its own on demand
+    class Utf32Cache {
+    public:
+      Utf32Cache() = default;
+      Utf32Cache(const Utf32Cache&) { }
+      Utf32Cache& operator=(const Utf32Cache&) {
+        reset();
+        return *this;
+      }
+      ~Utf32Cache() { reset(); }
+
+      template<typename F>
+      const std::u32string& get(F&& create) const {
+        const std::u32string* cached = string_.load(std::memory_order_acquire);
+        if (cached)
+          return *cached;
+
+        auto created = std::make_unique<const std::u32string>(create());
+        if (string_.compare_exchange_strong(cached, created.get(), std::memory_order_acq_rel))
+          return *created.release();
+        return *cached;
+      }
+
+      void reset() { delete string_.exchange(nullptr); }
+
+    private:
+      mutable std::atomic<const std::u32string*> string_ { nullptr };
+    };
+
+    Storage string_;
+    Utf32Cache utf32_cache_;
   };
 
   std::string encodeDataBase64(const char* data, size_t size);
@@ -0,0 +1,153 @@
+/* Copyright Vital Audio, LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "visage_utils/events.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+using namespace visage;
+
+TEST_CASE("CallbackList calls callbacks in order", "[utils]") {
+  std::vector<int> calls;
+  CallbackList<int(int)> list;
+  REQUIRE(list.callback(1) == 0);
+
+  list += [&calls](int value) {
+    calls.push_back(value);
+    return 1;
+  };
+  list += [&calls](int value) {
+    calls.push_back(value * 10);
+    return 2;
+  };
+
+  REQUIRE(list.numCallbacks() == 2);
+  REQUIRE(list.callback(3) == 2);
+  REQUIRE(calls == std::vector<int> { 3, 30 });
+}
+
+TEST_CASE("CallbackList removes by token", "[utils]") {
+  int first = 0, second = 0, third = 0;
+  CallbackList<void()> list;
+  CallbackToken token1 = list.add([&first] { first++; });
+  CallbackToken token2 = list.add([&second] { second++; });
+  CallbackToken token3 = list.add([&third] { third++; });
+
+  REQUIRE(list.remove(token2));
+  REQUIRE_FALSE(list.remove(token2));
+  list.callback();
+  REQUIRE(first == 1);
+  REQUIRE(second == 0);
+  REQUIRE(third == 1);
+
+  REQUIRE(list.remove(token1));
+  list.callback();
+  REQUIRE(first == 1);
+  REQUIRE(third == 2);
+
+  list -= token3;
+  REQUIRE(list.empty());
+  list.callback();
+  REQUIRE(third == 2);
+}
+
+TEST_CASE("CallbackList keeps same typed callbacks apart", "[utils]") {
+  std::vector<int> calls;
+  CallbackList<void()> list;
+  std::vector<CallbackToken> tokens;
+  for (int i = 0; i < 5; ++i)
+    tokens.push_back(list.add([&calls, i] { calls.push_back(i); }));
+
+  list.remove(tokens[3]);
+  list.remove(tokens[0]);
+  list.callback();
+  REQUIRE(calls == std::vector<int> { 1, 2, 4 });
+}
+
+TEST_CASE("CallbackList original callback", "[utils]") {
+  int original = 0, replacement = 0;
+  CallbackList<void()> list([&original] { original++; });
+  list.callback();
+  REQUIRE(original == 1);
+
+  list = [&replacement] { replacement++; };
+  list.callback();
+  REQUIRE(original == 1);
+  REQUIRE(replacement == 1);
+
+  list.reset();
+  list.callback();
+  REQUIRE(original == 2);
+  REQUIRE(replacement == 1);
+
+  CallbackList<void()> copy = list;
+  list.clear();
+  list.callback();
+  copy.callback();
+  REQUIRE(original == 3);
+}
+
+TEST_CASE("CallbackList removal during callback", "[utils]") {
+  int count = 0;
+  CallbackList<void()> list;
+  CallbackToken token;
+  token = list.add([&] {
+    count++;
+    list.remove(token);
+  });
+  list.add([&count] { count += 10; });
+
+  list.callback();
+  REQUIRE(count == 11);
+  list.callback();
+  REQUIRE(count == 21);
+  REQUIRE(list.numCallbacks() == 1);
+}
+
+TEST_CASE("CallbackList legacy std::function removal", "[utils]") {
+  int count = 0;
+  std::function<void()> callback = [&count] { count++; };
+  CallbackList<void()> list;
+  list += callback;
+  list += [&count] { count += 10; };
+  list -= callback;
+
+  list.callback();
+  REQUIRE(count == 10);
+
+  std::function<void()> missing = [] { };
+  list -= missing;
+  list.callback();
+  REQUIRE(count == 20);
+}
+
+TEST_CASE("Delegate stores large callables", "[utils]") {
+  std::vector<int> values = { 1, 2, 3 };
+  std::string name = "delegate";
+  Delegate<int(int)> delegate = [values, name](int index) { return values[index] + name.size(); };
+  Delegate<int(int)> copy = delegate;
+  Delegate<int(int)> moved = std::move(delegate);
+
+  REQUIRE_FALSE(delegate);
+  REQUIRE(copy(1) == 10);
+  REQUIRE(moved(2) == 11);
+}
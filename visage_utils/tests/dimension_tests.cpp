@@ -88,4 +88,100 @@ TEST_CASE("Dimension combination", "[utils]") {
   REQUIRE((view_max - view_min).compute(2, 198, 100) == 98.0f);
   REQUIRE((logical_pixels - device_pixels + zero).compute(2, 198, 100) == 99.0f);
   REQUIRE((2.0f * (logical_pixels - view_min)).compute(2, 198, 100) == 196.0f);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Dimension min and max", "[utils]") {
+  Dimension logical_pixels = 50_px;
+  Dimension half_view_width = 50_vw;
+
+  REQUIRE(Dimension::min(logical_pixels, half_view_width).compute(1, 200, 100) == 50.0f);
+  REQUIRE(Dimension::min(logical_pixels, half_view_width).compute(1, 60, 100) == 30.0f);
+  REQUIRE(logical_pixels.max(half_view_width).compute(1, 200, 100) == 100.0f);
+  REQUIRE(logical_pixels.max(half_view_width).compute(1, 60, 100) == 50.0f);
+  REQUIRE((logical_pixels / 2.0f).compute(2, 100, 100) == 50.0f);
+}
+
+TEST_CASE("Dimension custom compute function", "[utils]") {
+  Dimension custom(3.0f, [](float amount, float dpi_scale, float width, float height) {
+    return amount * dpi_scale + width - height;
+  });
+  REQUIRE(custom.compute(2, 100, 40) == 66.0f);
+
+  Dimension combined = custom + 10_px;
+  REQUIRE(combined.compute(2, 100, 40) == 86.0f);
+  REQUIRE((10_px - custom).compute(1, 100, 40) == -53.0f);
+}
+
+TEST_CASE("Dimension long expressions", "[utils]") {
+  Dimension sum = 1_npx;
+  Dimension nested = 1_npx;
+  for (int i = 0; i < 40; ++i) {
+    sum += 1_npx;
+    nested = 1_npx + nested;
+  }
+
+  REQUIRE(sum.compute(1, 100, 100) == 41.0f);
+  REQUIRE(nested.compute(1, 100, 100) == 41.0f);
+  REQUIRE(nested.computeInt(1, 100, 100) == 41);
+}
+
+TEST_CASE("Dimension deep expressions keep a small stack", "[utils]") {
+  Dimension nested = 1_npx;
+  float expected = 1.0f;
+  for (int i = 0; i < 5000; ++i) {
+    nested = Dimension::nativePixels(i) - nested;
+    expected = i - expected;
+  }
+
+  REQUIRE(nested.compute(1, 100, 100) == expected);
+  REQUIRE(nested.maxStackSize() <= 2);
+
+  std::vector<Dimension> level;
+  for (int i = 0; i < 4096; ++i)
+    level.push_back(Dimension::nativePixels(1.0f));
+  while (level.size() > 1) {
+    std::vector<Dimension> next;
+    for (size_t i = 0; i < level.size(); i += 2)
+      next.push_back(level[i] + level[i + 1]);
+    level = next;
+  }
+
+  REQUIRE(level[0].compute(1, 100, 100) == 4096.0f);
+  REQUIRE(level[0].maxStackSize() <= 13);
+  REQUIRE(level[0].maxStackSize() <= Dimension::kMaxStackSize);
+}
+
+TEST_CASE("Dimension composed programs stay short and shared", "[utils]") {
+  Dimension sum = 0_npx;
+  for (int i = 0; i < 5000; ++i) {
+    sum += 1_npx;
+    REQUIRE(sum.numInstructions() <= 2 * Dimension::kMaxInlineInstructions + 1);
+  }
+  REQUIRE(sum.compute(1, 100, 100) == 5000.0f);
+
+  Dimension copy = sum;
+  REQUIRE(copy.instructions() == sum.instructions());
+  REQUIRE(copy.compute(1, 100, 100) == 5000.0f);
+}
+
+TEST_CASE("Dimension many custom functions", "[utils]") {
+  Dimension sum = 0_npx;
+  for (int i = 0; i < 300; ++i)
+    sum += Dimension(i, [](float amount, float, float, float) { return amount; });
+
+  REQUIRE(sum.compute(1, 100, 100) == 299.0f * 300.0f / 2.0f);
+}
+
+TEST_CASE("Dimension assigned compute function", "[utils]") {
+  Dimension dimension;
+  REQUIRE(dimension.compute(1, 100, 100, 7.0f) == 7.0f);
+
+  dimension.amount = 4.0f;
+  dimension.compute_function = [](float amount, float dpi_scale, float, float) {
+    return amount * dpi_scale;
+  };
+  REQUIRE(dimension.compute(3, 100, 100) == 12.0f);
+  REQUIRE(dimension.computeInt(3, 100, 100) == 12);
+  REQUIRE((dimension + 10_npx).compute(3, 100, 100) == 22.0f);
+  REQUIRE((10_npx - dimension).compute(3, 100, 100) == -2.0f);
+}
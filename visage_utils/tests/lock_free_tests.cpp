@@ -0,0 +1,224 @@
+/* Copyright Vital Audio, LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "visage_utils/lock_free.h"
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace visage;
+
+TEST_CASE("Mpsc queue pops in order", "[utils]") {
+  MpscQueue<int> queue;
+  int value = 0;
+  REQUIRE(queue.empty());
+  REQUIRE_FALSE(queue.tryPop(value));
+
+  for (int i = 0; i < 10; ++i)
+    queue.push(i);
+
+  REQUIRE_FALSE(queue.empty());
+  for (int i = 0; i < 10; ++i) {
+    REQUIRE(queue.tryPop(value));
+    REQUIRE(value == i);
+  }
+  REQUIRE(queue.empty());
+  REQUIRE_FALSE(queue.tryPop(value));
+}
+
+TEST_CASE("Mpsc queue releases remaining values", "[utils]") {
+  std::shared_ptr<int> shared = std::make_shared<int>(1);
+  {
+    MpscQueue<std::shared_ptr<int>> queue;
+    queue.push(shared);
+    queue.push(shared);
+    std::shared_ptr<int> popped;
+    REQUIRE(queue.tryPop(popped));
+    REQUIRE(shared.use_count() == 3);
+  }
+  REQUIRE(shared.use_count() == 1);
+}
+
+TEST_CASE("Mpsc queue multiple producers", "[utils]") {
+  static constexpr int kNumProducers = 8;
+  static constexpr int kValuesPerProducer = 20000;
+
+  MpscQueue<int> queue;
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kNumProducers; ++p) {
+    producers.emplace_back([&queue, p] {
+      for (int i = 0; i < kValuesPerProducer; ++i)
+        queue.push(p * kValuesPerProducer + i);
+    });
+  }
+
+  std::vector<int> next(kNumProducers, 0);
+  int received = 0;
+  int value = 0;
+  bool in_order = true;
+  while (received < kNumProducers * kValuesPerProducer) {
+    if (!queue.tryPop(value)) {
+      std::this_thread::yield();
+      continue;
+    }
+
+    int producer = value / kValuesPerProducer;
+    in_order = in_order && value % kValuesPerProducer == next[producer];
+    next[producer]++;
+    received++;
+  }
+
+  for (auto& producer : producers)
+    producer.join();
+
+  REQUIRE(in_order);
+  REQUIRE(queue.empty());
+  for (int count : next)
+    REQUIRE(count == kValuesPerProducer);
+}
+
+TEST_CASE("Spsc ring buffer wraps around", "[utils]") {
+  SpscRingBuffer<int> buffer(5);
+  REQUIRE(buffer.capacity() == 8);
+  REQUIRE(buffer.numAvailable() == 0);
+  REQUIRE(buffer.numFree() == 8);
+
+  int value = 0;
+  REQUIRE_FALSE(buffer.pop(value));
+
+  int next_write = 0;
+  int next_read = 0;
+  for (int round = 0; round < 10; ++round) {
+    for (int i = 0; i < 6; ++i)
+      REQUIRE(buffer.push(next_write++));
+    REQUIRE(buffer.numAvailable() == 6);
+
+    for (int i = 0; i < 6; ++i) {
+      REQUIRE(buffer.pop(value));
+      REQUIRE(value == next_read++);
+    }
+  }
+
+  int block[10] {};
+  for (int i = 0; i < 10; ++i)
+    block[i] = i;
+  REQUIRE(buffer.write(block, 10) == 8);
+  REQUIRE_FALSE(buffer.push(10));
+
+  int result[10] {};
+  REQUIRE(buffer.read(result, 10) == 8);
+  for (int i = 0; i < 8; ++i)
+    REQUIRE(result[i] == i);
+}
+
+TEST_CASE("Spsc ring buffer across threads", "[utils]") {
+  static constexpr int kNumValues = 200000;
+  static constexpr int kBlockSize = 37;
+
+  SpscRingBuffer<int> buffer(256);
+  std::thread producer([&buffer] {
+    int block[kBlockSize];
+    int next = 0;
+    while (next < kNumValues) {
+      int num = std::min(kBlockSize, kNumValues - next);
+      for (int i = 0; i < num; ++i)
+        block[i] = next + i;
+
+      int written = buffer.write(block, num);
+      next += written;
+      if (written == 0)
+        std::this_thread::yield();
+    }
+  });
+
+  int expected = 0;
+  bool in_order = true;
+  int block[kBlockSize];
+  while (expected < kNumValues) {
+    int num = buffer.read(block, kBlockSize);
+    for (int i = 0; i < num; ++i)
+      in_order = in_order && block[i] == expected++;
+    if (num == 0)
+      std::this_thread::yield();
+  }
+
+  producer.join();
+  REQUIRE(in_order);
+  REQUIRE(buffer.numAvailable() == 0);
+}
+
+TEST_CASE("Triple buffer keeps the latest value", "[utils]") {
+  TripleBuffer<int> buffer(0);
+  REQUIRE_FALSE(buffer.hasUpdate());
+  REQUIRE_FALSE(buffer.update());
+  REQUIRE(buffer.readBuffer() == 0);
+
+  buffer.writeBuffer() = 1;
+  buffer.publish();
+  buffer.writeBuffer() = 2;
+  buffer.publish();
+  REQUIRE(buffer.hasUpdate());
+  REQUIRE(buffer.update());
+  REQUIRE(buffer.readBuffer() == 2);
+  REQUIRE_FALSE(buffer.update());
+  REQUIRE(buffer.readBuffer() == 2);
+
+  buffer.writeBuffer() = 3;
+  buffer.publish();
+  REQUIRE(buffer.update());
+  REQUIRE(buffer.readBuffer() == 3);
+}
+
+TEST_CASE("Triple buffer snapshots are never torn", "[utils]") {
+  static constexpr int kSnapshotSize = 64;
+  static constexpr int kNumSnapshots = 50000;
+
+  TripleBuffer<std::vector<int>> buffer(std::vector<int>(kSnapshotSize, 0));
+  std::thread producer([&buffer] {
+    for (int i = 1; i <= kNumSnapshots; ++i) {
+      std::vector<int>& values = buffer.writeBuffer();
+      for (int& value : values)
+        value = i;
+      buffer.publish();
+    }
+  });
+
+  int last = 0;
+  bool consistent = true;
+  while (last < kNumSnapshots) {
+    if (!buffer.update()) {
+      std::this_thread::yield();
+      continue;
+    }
+
+    const std::vector<int>& values = buffer.readBuffer();
+    for (int value : values)
+      consistent = consistent && value == values[0];
+    consistent = consistent && values[0] > last;
+    last = values[0];
+  }
+
+  producer.join();
+  REQUIRE(consistent);
+}
@@ -21,11 +21,133 @@
 
 #include "visage_utils/string_utils.h"
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <random>
+#include <thread>
 
 using namespace visage;
 
+namespace {
+  std::u32string scalarUtf8ToUtf32(const std::string& utf8_str) {
+    std::u32string result;
+    for (size_t i = 0; i < utf8_str.size(); ++i) {
+      unsigned char ch = utf8_str[i];
+      if (ch < 0x80)
+        result.push_back(ch);
+      else if (ch < 0xC0)
+        result.push_back('*');
+      else if (ch < 0xE0) {
+        if (i + 1 >= utf8_str.size())
+          return result;
+        result.push_back(((ch & 0x1F) << 6) | (utf8_str[i + 1] & 0x3F));
+        i += 1;
+      }
+      else if (ch < 0xF0) {
+        if (i + 2 >= utf8_str.size())
+          return result;
+        result.push_back(((ch & 0x0F) << 12) | ((utf8_str[i + 1] & 0x3F) << 6) |
+                         (utf8_str[i + 2] & 0x3F));
+        i += 2;
+      }
+      else if (ch < 0xF8) {
+        if (i + 3 >= utf8_str.size())
+          return result;
+        result.push_back(((ch & 0x07) << 18) | ((utf8_str[i + 1] & 0x3F) << 12) |
+                         ((utf8_str[i + 2] & 0x3F) << 6) | (utf8_str[i + 3] & 0x3F));
+        i += 3;
+      }
+      else
+        return result;
+    }
+    return result;
+  }
+
+  std::string scalarUtf32ToUtf8(const std::u32string& utf32_str) {
+    std::string result;
+    for (char32_t character : utf32_str) {
+      if (character < 0x80)
+        result.push_back(static_cast<char>(character));
+      else if (character < 0x800) {
+        result.push_back(static_cast<char>((character >> 6) | 0xC0));
+        result.push_back(static_cast<char>((character & 0x3F) | 0x80));
+      }
+      else if (character < 0x10000) {
+        result.push_back(static_cast<char>((character >> 12) | 0xE0));
+        result.push_back(static_cast<char>(((character >> 6) & 0x3F) | 0x80));
+        result.push_back(static_cast<char>((character & 0x3F) | 0x80));
+      }
+      else if (character < 0x110000) {
+        result.push_back(static_cast<char>((character >> 18) | 0xF0));
+        result.push_back(static_cast<char>(((character >> 12) & 0x3F) | 0x80));
+        result.push_back(static_cast<char>(((character >> 6) & 0x3F) | 0x80));
+        result.push_back(static_cast<char>((character & 0x3F) | 0x80));
+      }
+      else
+        return result;
+    }
+    return result;
+  }
+
+  std::u16string scalarUtf32ToUtf16(const std::u32string& utf32_str) {
+    std::u16string result;
+    for (char32_t character : utf32_str) {
+      if (character <= 0xFFFF) {
+        if (character >= 0xD800 && character <= 0xDFFF)
+          return result;
+        result.push_back(static_cast<char16_t>(character));
+      }
+      else if (character <= 0x10FFFF) {
+        character -= 0x10000;
+        result.push_back(static_cast<char16_t>((character >> 10) + 0xD800));
+        result.push_back(static_cast<char16_t>((character & 0x3FF) + 0xDC00));
+      }
+      else
+        return result;
+    }
+    return result;
+  }
+
+  std::u32string scalarUtf16ToUtf32(const std::u16string& utf16_str) {
+    std::u32string result;
+    for (size_t i = 0; i < utf16_str.size(); ++i) {
+      char16_t ch = utf16_str[i];
+      if (ch >= 0xD800 && ch <= 0xDBFF) {
+        if (i + 1 >= utf16_str.size())
+          return result;
+        char16_t low_surrogate = utf16_str[++i];
+        if (low_surrogate < 0xDC00 || low_surrogate > 0xDFFF)
+          return result;
+        result.push_back(0x10000 + ((ch - 0xD800) << 10) + (low_surrogate - 0xDC00));
+      }
+      else if (ch >= 0xDC00 && ch <= 0xDFFF)
+        return result;
+      else
+        result.push_back(ch);
+    }
+    return result;
+  }
+
+  // Mostly ASCII runs of varying length with occasional multi-byte and invalid characters
+  std::u32string randomUtf32(std::mt19937& random, int length, int error_rate) {
+    static constexpr char32_t kSamples[] = { 0xE9,   0x3A9,   0x20AC,  0x4E2D,
+                                             0xFFFD, 0x1F602, 0x10FFFF };
+    std::u32string result;
+    while (result.size() < static_cast<size_t>(length)) {
+      int run = random() % 40;
+      for (int i = 0; i < run; ++i)
+        result.push_back(' ' + random() % 95);
+      result.push_back(kSamples[random() % (sizeof(kSamples) / sizeof(kSamples[0]))]);
+      if (error_rate && random() % error_rate == 0)
+        result.push_back(random() % 2 ? 0xD800 + random() % 0x800 : 0x110000 + random() % 1000);
+    }
+    result.resize(length);
+    return result;
+  }
+}
+
 TEST_CASE("String conversion", "[utils]") {
   std::u32string original = U"Hello, \U0001F602 \u00E0\u00C0\u00E8!";
   String test = original;
@@ -35,6 +157,127 @@ TEST_CASE("String conversion", "[utils]") {
   REQUIRE(String(wide).toUtf32() == original);
 }
 
+TEST_CASE("Vectorized UTF conversion matches scalar", "[utils]") {
+  std::mt19937 random(0);
+  for (int i = 0; i < 200; ++i) {
+    std::u32string valid = randomUtf32(random, random() % 300, 0);
+    std::u32string invalid = randomUtf32(random, random() % 300, 4);
+
+    std::string utf8 = scalarUtf32ToUtf8(valid);
+    REQUIRE(String::convertToUtf32(utf8) == scalarUtf8ToUtf32(utf8));
+    REQUIRE(String::convertToUtf32(utf8) == valid);
+    REQUIRE(String::convertToUtf8(valid) == utf8);
+    REQUIRE(String::convertToUtf8(invalid) == scalarUtf32ToUtf8(invalid));
+
+    std::u16string utf16 = scalarUtf32ToUtf16(valid);
+    REQUIRE(String::convertUtf32ToUtf16<std::u16string>(valid) == utf16);
+    REQUIRE(String::convertUtf16ToUtf32(utf16) == valid);
+    REQUIRE(String::convertUtf32ToUtf16<std::u16string>(invalid) == scalarUtf32ToUtf16(invalid));
+
+    std::string corrupt_utf8 = utf8;
+    for (int c = 0; c < 3 && !corrupt_utf8.empty(); ++c)
+      corrupt_utf8[random() % corrupt_utf8.size()] = static_cast<char>(0x80 + random() % 0x80);
+    REQUIRE(String::convertToUtf32(corrupt_utf8) == scalarUtf8ToUtf32(corrupt_utf8));
+
+    std::u16string corrupt_utf16 = utf16;
+    if (!corrupt_utf16.empty())
+      corrupt_utf16[random() % corrupt_utf16.size()] = 0xD800 + random() % 0x800;
+    REQUIRE(String::convertUtf16ToUtf32(corrupt_utf16) == scalarUtf16ToUtf32(corrupt_utf16));
+  }
+}
+
+TEST_CASE("UTF conversion throughput", "[utils][.benchmark]") {
+  std::mt19937 random(0);
+  std::string ascii(1 << 20, 'a');
+  std::u32string mixed = randomUtf32(random, 1 << 20, 0);
+  std::string mixed_utf8 = scalarUtf32ToUtf8(mixed);
+  std::u16string mixed_utf16 = scalarUtf32ToUtf16(mixed);
+
+  BENCHMARK("ASCII UTF-8 to UTF-32") {
+    return String::convertToUtf32(ascii).size();
+  };
+
+  BENCHMARK("Mixed UTF-8 to UTF-32") {
+    return String::convertToUtf32(mixed_utf8).size();
+  };
+
+  BENCHMARK("Mixed UTF-32 to UTF-8") {
+    return String::convertToUtf8(mixed).size();
+  };
+
+  BENCHMARK("Mixed UTF-16 to UTF-32") {
+    return String::convertUtf16ToUtf32(mixed_utf16).size();
+  };
+
+  BENCHMARK("Mixed UTF-32 to UTF-16") {
+    return String::convertUtf32ToUtf16<std::u16string>(mixed).size();
+  };
+}
+
+TEST_CASE("Compact string representations", "[utils]") {
+  std::u32string latin1 = U"Volume \u00E9";
+  std::u32string ucs2 = U"\u20AC \u4E2D";
+  std::u32string utf32 = U"\U0001F602!";
+
+  String string = latin1;
+  REQUIRE(string.length() == latin1.size());
+  REQUIRE(string.toUtf32() == latin1);
+  REQUIRE(string[7] == 0xE9);
+  REQUIRE(String(string.toUtf8()) == string);
+
+  string += ucs2;
+  REQUIRE(string == latin1 + ucs2);
+  string += String(utf32);
+  REQUIRE(string == latin1 + ucs2 + utf32);
+  REQUIRE(std::u32string(string.c_str()) == latin1 + ucs2 + utf32);
+  REQUIRE(string.find(0x1F602) == latin1.size() + ucs2.size());
+  REQUIRE(string.contains(ucs2));
+  REQUIRE(string.endsWith(utf32));
+  REQUIRE(String(latin1).endsWith('\xE9'));
+
+  String compact = latin1 + ucs2;
+  REQUIRE(compact < string);
+  REQUIRE(string > compact);
+  REQUIRE(compact != string);
+  REQUIRE(String(latin1) < String(ucs2));
+  REQUIRE(String(U"  \u4E2D  ").trim() == U"\u4E2D");
+  REQUIRE(string.substring(latin1.size(), ucs2.size()) == ucs2);
+
+  string += string;
+  REQUIRE(string.length() == 2 * (latin1.size() + ucs2.size() + utf32.size()));
+}
+
+TEST_CASE("Reading a compact string keeps it compact", "[utils]") {
+  auto character_size = [](const String& string) {
+    return string.visitCharacters([](auto* characters, size_t) { return sizeof(*characters); });
+  };
+
+  const String label = U"Volume \u00E9";
+  std::vector<std::thread> readers;
+  std::vector<std::u32string> results(4);
+  for (auto& result : results)
+    readers.emplace_back([&label, &result] { result = label.c_str(); });
+  for (auto& reader : readers)
+    reader.join();
+
+  for (const auto& result : results)
+    REQUIRE(result == U"Volume \u00E9");
+  REQUIRE(character_size(label) == 1);
+
+  String copy = label;
+  REQUIRE(std::u32string(copy.c_str()) == U"Volume \u00E9");
+  copy += U"\u20AC";
+  REQUIRE(std::u32string(copy.c_str()) == U"Volume \u00E9\u20AC");
+  REQUIRE(character_size(copy) == 2);
+
+  copy.clear();
+  REQUIRE(std::u32string(copy.c_str()).empty());
+
+  String utf32 = U"\U0001F602";
+  REQUIRE(utf32.c_str() == utf32.c_str());
+  REQUIRE(character_size(utf32) == 4);
+}
+
 TEST_CASE("Base 64 conversion", "[utils]") {
   static constexpr int kMaxSize = 10000;
   int size = 1 + (rand() % (kMaxSize - 1));
@@ -91,3 +334,77 @@ TEST_CASE("String numerical precision", "[utils]") {
   REQUIRE(test2.withPrecision(7).toUtf8() == "9.9995493");
   REQUIRE(test2.withPrecision(8).toUtf8() == "9.99954930");
 }
+
+TEST_CASE("String number formatting", "[utils]") {
+  REQUIRE(String(0.5f) == "0.5");
+  REQUIRE(String(-2.0) == "-2");
+  REQUIRE(String(1e-9) == "0");
+  REQUIRE(String(-9.9996, 2) == "-10.00");
+  REQUIRE(String(42) == "42");
+  REQUIRE(String(-1234567890123ll) == "-1234567890123");
+  REQUIRE(String::shortest(0.1f) == "0.1");
+  REQUIRE(String::shortest(1.0 / 3.0) == "0.3333333333333333");
+
+  std::mt19937 random(0);
+  std::uniform_real_distribution<double> mantissa(-10.0, 10.0);
+  for (int i = 0; i < 2000; ++i) {
+    double value = mantissa(random) * std::pow(10.0, static_cast<int>(random() % 12) - 6);
+    int precision = random() % 9;
+
+    String text(std::to_string(value));
+    REQUIRE(String(value, precision) == text.withPrecision(precision));
+    text.removeTrailingZeros();
+    REQUIRE(String(value) == text);
+
+    float float_value = static_cast<float>(value);
+    REQUIRE(std::stof(String::shortest(float_value).toUtf8()) == float_value);
+    REQUIRE(std::stod(String::shortest(value).toUtf8()) == value);
+  }
+}
+
+TEST_CASE("Format 1M floats", "[utils][.benchmark]") {
+  static constexpr int kNumValues = 1000000;
+  std::mt19937 random(0);
+  std::uniform_real_distribution<float> distribution(-1000.0f, 1000.0f);
+  std::vector<float> values(kNumValues);
+  for (float& value : values)
+    value = distribution(random);
+
+  BENCHMARK("std::to_string and trimming") {
+    size_t total = 0;
+    for (float value : values) {
+      String text(std::to_string(value));
+      text.removeTrailingZeros();
+      total += text.length();
+    }
+    return total;
+  };
+
+  BENCHMARK("String(float)") {
+    size_t total = 0;
+    for (float value : values)
+      total += String(value).length();
+    return total;
+  };
+
+  BENCHMARK("std::to_string with precision") {
+    size_t total = 0;
+    for (float value : values)
+      total += String(std::to_string(value)).withPrecision(2).length();
+    return total;
+  };
+
+  BENCHMARK("String(float, precision)") {
+    size_t total = 0;
+    for (float value : values)
+      total += String(value, 2).length();
+    return total;
+  };
+
+  BENCHMARK("String::shortest") {
+    size_t total = 0;
+    for (float value : values)
+      total += String::shortest(value).length();
+    return total;
+  };
+}
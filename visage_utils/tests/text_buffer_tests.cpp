@@ -0,0 +1,138 @@
+/* Copyright Vital Audio, LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "visage_utils/text_buffer.h"
+
+#include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace visage;
+
+namespace {
+  int referenceLineStart(const std::u32string& text, int line) {
+    int index = 0;
+    for (int i = 0; i < line; ++i) {
+      size_t position = text.find(U'\n', index);
+      if (position == std::u32string::npos)
+        return text.size();
+      index = position + 1;
+    }
+    return index;
+  }
+
+  void checkMatches(const TextBuffer& buffer, const std::u32string& reference) {
+    REQUIRE(buffer.length() == reference.size());
+    REQUIRE(buffer.toString() == reference);
+
+    int new_lines = std::count(reference.begin(), reference.end(), U'\n');
+    REQUIRE(buffer.numNewLines() == new_lines);
+    for (int line = 0; line <= new_lines; ++line)
+      REQUIRE(buffer.lineStart(line) == referenceLineStart(reference, line));
+  }
+}
+
+TEST_CASE("Text buffer edits", "[utils]") {
+  TextBuffer buffer(U"Hello\nWorld");
+  checkMatches(buffer, U"Hello\nWorld");
+  REQUIRE(buffer.at(6) == U'W');
+  REQUIRE(buffer.lineAtIndex(5) == 0);
+  REQUIRE(buffer.lineAtIndex(6) == 1);
+  REQUIRE(buffer.lineEnd(0) == 6);
+  REQUIRE(buffer.lineEnd(1) == 11);
+
+  buffer.insert(5, U",");
+  buffer.insert(6, U" there");
+  checkMatches(buffer, U"Hello, there\nWorld");
+  REQUIRE(buffer.numPieces() == 3);
+
+  buffer.erase(0, 7);
+  checkMatches(buffer, U"there\nWorld");
+  buffer.insert(buffer.length(), U"\n\n!");
+  checkMatches(buffer, U"there\nWorld\n\n!");
+  REQUIRE(buffer.substring(3, 5) == U"re\nWo");
+
+  buffer.erase(5, 1);
+  checkMatches(buffer, U"thereWorld\n\n!");
+  buffer.erase(0, buffer.length());
+  checkMatches(buffer, U"");
+}
+
+TEST_CASE("Text buffer random edits match a string", "[utils]") {
+  static constexpr int kNumEdits = 2000;
+  static constexpr char32_t kCharacters[] = U"ab \n";
+
+  std::u32string reference = U"The quick\nbrown fox\n";
+  TextBuffer buffer(reference);
+  srand(1);
+
+  for (int i = 0; i < kNumEdits; ++i) {
+    int index = rand() % (reference.size() + 1);
+    if (rand() % 3 == 0 && !reference.empty()) {
+      int length = 1 + rand() % 8;
+      buffer.erase(index, length);
+      if (index < reference.size())
+        reference.erase(index, length);
+    }
+    else {
+      std::u32string text;
+      int length = 1 + rand() % 6;
+      for (int c = 0; c < length; ++c)
+        text.push_back(kCharacters[rand() % 4]);
+      buffer.insert(index, text);
+      reference.insert(index, text);
+    }
+
+    REQUIRE(buffer.length() == reference.size());
+    int probe = reference.empty() ? 0 : rand() % reference.size();
+    if (!reference.empty())
+      REQUIRE(buffer.at(probe) == reference[probe]);
+    int new_lines_before = std::count(reference.begin(), reference.begin() + probe, U'\n');
+    REQUIRE(buffer.lineAtIndex(probe) == new_lines_before);
+  }
+
+  checkMatches(buffer, reference);
+}
+
+TEST_CASE("Text buffer typing coalesces pieces", "[utils]") {
+  TextBuffer buffer(std::u32string(1000, U'x'));
+  for (int i = 0; i < 100; ++i)
+    buffer.insert(500 + i, U"y");
+
+  REQUIRE(buffer.numPieces() == 3);
+  REQUIRE(buffer.substring(499, 102) == U"x" + std::u32string(100, U'y') + U"x");
+}
+
+TEST_CASE("Text buffer typing in a large document", "[utils][.benchmark]") {
+  static constexpr int kDocumentSize = 1 << 20;
+
+  std::u32string document;
+  for (int i = 0; i < kDocumentSize; ++i)
+    document.push_back(i % 64 == 63 ? U'\n' : U'a' + i % 26);
+
+  TextBuffer buffer(document);
+  int position = kDocumentSize / 2;
+  BENCHMARK("Type a character in the middle") {
+    buffer.insert(position, U"x");
+    position += 7;
+    return buffer.lineAtIndex(position);
+  };
+}
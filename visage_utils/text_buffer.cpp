@@ -0,0 +1,310 @@
+/* Copyright Vital Audio, LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "text_buffer.h"
+
+#include <algorithm>
+
+namespace visage {
+  void TextBuffer::setText(std::u32string text) {
+    original_ = std::move(text);
+    added_.clear();
+    original_new_lines_.clear();
+    added_new_lines_.clear();
+    nodes_.clear();
+    free_nodes_.clear();
+    root_ = -1;
+
+    for (int i = 0; i < original_.size(); ++i) {
+      if (original_[i] == '\n')
+        original_new_lines_.push_back(i);
+    }
+
+    if (!original_.empty())
+      root_ = createNode(false, 0, original_.size());
+  }
+
+  void TextBuffer::insert(int index, const std::u32string& text) {
+    if (text.empty())
+      return;
+
+    index = std::max(0, std::min(length(), index));
+    int added_start = added_.size();
+    int text_length = text.size();
+    added_ += text;
+    for (int i = 0; i < text_length; ++i) {
+      if (text[i] == '\n')
+        added_new_lines_.push_back(added_start + i);
+    }
+
+    int left = -1, right = -1;
+    split(root_, index, left, right);
+    if (!extendLastPiece(left, added_start, text_length))
+      left = merge(left, createNode(true, added_start, text_length));
+    root_ = merge(left, right);
+  }
+
+  void TextBuffer::erase(int index, int length) {
+    index = std::max(0, std::min(this->length(), index));
+    length = std::min(length, this->length() - index);
+    if (length <= 0)
+      return;
+
+    int left = -1, middle = -1, right = -1;
+    split(root_, index, left, right);
+    split(right, length, middle, right);
+    freeTree(middle);
+    root_ = merge(left, right);
+  }
+
+  char32_t TextBuffer::at(int index) const {
+    int node = root_;
+    while (node >= 0) {
+      const Node& n = nodes_[node];
+      int left_length = n.left < 0 ? 0 : nodes_[n.left].total_length;
+      if (index < left_length)
+        node = n.left;
+      else if (index < left_length + n.length)
+        return source(n)[n.start + index - left_length];
+      else {
+        index -= left_length + n.length;
+        node = n.right;
+      }
+    }
+    return 0;
+  }
+
+  std::u32string TextBuffer::substring(int start, int length) const {
+    std::u32string result;
+    start = std::max(0, start);
+    int end = std::min(this->length(), start + length);
+    if (end > start) {
+      result.reserve(end - start);
+      collect(root_, start, end, result);
+    }
+    return result;
+  }
+
+  int TextBuffer::lineStart(int line) const {
+    if (line <= 0)
+      return 0;
+    if (line > numNewLines())
+      return length();
+
+    int node = root_;
+    int offset = 0;
+    while (node >= 0) {
+      const Node& n = nodes_[node];
+      int left_length = n.left < 0 ? 0 : nodes_[n.left].total_length;
+      int left_new_lines = n.left < 0 ? 0 : nodes_[n.left].total_new_lines;
+      if (line <= left_new_lines)
+        node = n.left;
+      else if (line <= left_new_lines + n.new_lines) {
+        const std::vector<int>& new_lines = newLines(n.added);
+        auto first = std::lower_bound(new_lines.begin(), new_lines.end(), n.start);
+        int position = *(first + (line - left_new_lines - 1));
+        return offset + left_length + position - n.start + 1;
+      }
+      else {
+        line -= left_new_lines + n.new_lines;
+        offset += left_length + n.length;
+        node = n.right;
+      }
+    }
+    return length();
+  }
+
+  int TextBuffer::lineEnd(int line) const {
+    if (line < numNewLines())
+      return lineStart(line + 1);
+    return length();
+  }
+
+  int TextBuffer::lineAtIndex(int index) const {
+    int node = root_;
+    int line = 0;
+    while (node >= 0) {
+      const Node& n = nodes_[node];
+      int left_length = n.left < 0 ? 0 : nodes_[n.left].total_length;
+      int left_new_lines = n.left < 0 ? 0 : nodes_[n.left].total_new_lines;
+      if (index < left_length)
+        node = n.left;
+      else if (index < left_length + n.length)
+        return line + left_new_lines + countNewLines(n.added, n.start, index - left_length);
+      else {
+        line += left_new_lines + n.new_lines;
+        index -= left_length + n.length;
+        node = n.right;
+      }
+    }
+    return line;
+  }
+
+  int TextBuffer::countNewLines(bool added, int start, int length) const {
+    const std::vector<int>& new_lines = newLines(added);
+    auto begin = std::lower_bound(new_lines.begin(), new_lines.end(), start);
+    auto end = std::lower_bound(begin, new_lines.end(), start + length);
+    return end - begin;
+  }
+
+  int TextBuffer::createNode(bool added, int start, int length) {
+    random_state_ ^= random_state_ << 13;
+    random_state_ ^= random_state_ >> 17;
+    random_state_ ^= random_state_ << 5;
+
+    Node node;
+    node.added = added;
+    node.start = start;
+    node.length = length;
+    node.new_lines = countNewLines(added, start, length);
+    node.total_length = length;
+    node.total_new_lines = node.new_lines;
+    node.priority = random_state_;
+
+    if (free_nodes_.empty()) {
+      nodes_.push_back(node);
+      return nodes_.size() - 1;
+    }
+
+    int index = free_nodes_.back();
+    free_nodes_.pop_back();
+    nodes_[index] = node;
+    return index;
+  }
+
+  void TextBuffer::freeTree(int node) {
+    if (node < 0)
+      return;
+
+    freeTree(nodes_[node].left);
+    freeTree(nodes_[node].right);
+    free_nodes_.push_back(node);
+  }
+
+  void TextBuffer::update(int node) {
+    Node& n = nodes_[node];
+    n.total_length = n.length;
+    n.total_new_lines = n.new_lines;
+    if (n.left >= 0) {
+      n.total_length += nodes_[n.left].total_length;
+      n.total_new_lines += nodes_[n.left].total_new_lines;
+    }
+    if (n.right >= 0) {
+      n.total_length += nodes_[n.right].total_length;
+      n.total_new_lines += nodes_[n.right].total_new_lines;
+    }
+  }
+
+  void TextBuffer::split(int node, int index, int& left, int& right) {
+    if (node < 0) {
+      left = right = -1;
+      return;
+    }
+
+    int left_length = nodes_[node].left < 0 ? 0 : nodes_[nodes_[node].left].total_length;
+    int piece_length = nodes_[node].length;
+    if (index <= left_length) {
+      int sub_right = -1;
+      split(nodes_[node].left, index, left, sub_right);
+      nodes_[node].left = sub_right;
+      update(node);
+      right = node;
+    }
+    else if (index >= left_length + piece_length) {
+      int sub_left = -1;
+      split(nodes_[node].right, index - left_length - piece_length, sub_left, right);
+      nodes_[node].right = sub_left;
+      update(node);
+      left = node;
+    }
+    else {
+      int offset = index - left_length;
+      int tail = createNode(nodes_[node].added, nodes_[node].start + offset, piece_length - offset);
+      Node& n = nodes_[node];
+      int old_right = n.right;
+      n.length = offset;
+      n.new_lines = countNewLines(n.added, n.start, n.length);
+      n.right = -1;
+      update(node);
+      left = node;
+      right = merge(tail, old_right);
+    }
+  }
+
+  int TextBuffer::merge(int left, int right) {
+    if (left < 0)
+      return right;
+    if (right < 0)
+      return left;
+
+    if (nodes_[left].priority > nodes_[right].priority) {
+      int merged = merge(nodes_[left].right, right);
+      nodes_[left].right = merged;
+      update(left);
+      return left;
+    }
+
+    int merged = merge(left, nodes_[right].left);
+    nodes_[right].left = merged;
+    update(right);
+    return right;
+  }
+
+  bool TextBuffer::extendLastPiece(int node, int added_start, int length) {
+    if (node < 0)
+      return false;
+
+    bool extended = false;
+    if (nodes_[node].right >= 0)
+      extended = extendLastPiece(nodes_[node].right, added_start, length);
+    else {
+      Node& n = nodes_[node];
+      extended = n.added && n.start + n.length == added_start;
+      if (extended) {
+        n.length += length;
+        n.new_lines = countNewLines(true, n.start, n.length);
+      }
+    }
+
+    if (extended)
+      update(node);
+    return extended;
+  }
+
+  void TextBuffer::collect(int node, int start, int end, std::u32string& result) const {
+    if (node < 0 || start >= end)
+      return;
+
+    const Node& n = nodes_[node];
+    int left_length = n.left < 0 ? 0 : nodes_[n.left].total_length;
+    if (start < left_length)
+      collect(n.left, start, std::min(end, left_length), result);
+
+    int piece_start = std::max(start, left_length);
+    int piece_end = std::min(end, left_length + n.length);
+    if (piece_start < piece_end)
+      result.append(source(n), n.start + piece_start - left_length, piece_end - piece_start);
+
+    int right_offset = left_length + n.length;
+    if (end > right_offset)
+      collect(n.right, std::max(0, start - right_offset), end - right_offset, result);
+  }
+}
@@ -0,0 +1,91 @@
+/* Copyright Vital Audio, LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace visage {
+  // Piece table over an original and an append-only buffer. Pieces are kept in a treap ordered
+  // by text position so edits, indexing and line lookups are O(log n) in the number of pieces.
+  class TextBuffer {
+  public:
+    TextBuffer() = default;
+    explicit TextBuffer(std::u32string text) { setText(std::move(text)); }
+
+    void setText(std::u32string text);
+    void insert(int index, const std::u32string& text);
+    void erase(int index, int length);
+
+    int length() const { return root_ < 0 ? 0 : nodes_[root_].total_length; }
+    bool isEmpty() const { return length() == 0; }
+    int numNewLines() const { return root_ < 0 ? 0 : nodes_[root_].total_new_lines; }
+    int numLines() const { return numNewLines() + 1; }
+    int numPieces() const { return nodes_.size() - free_nodes_.size(); }
+
+    char32_t at(int index) const;
+    std::u32string substring(int start, int length) const;
+    std::u32string toString() const { return substring(0, length()); }
+
+    // Index of the first character of hard line _line_, the text after its preceding new line
+    int lineStart(int line) const;
+    // Index just past the new line ending hard line _line_, or the length for the last line
+    int lineEnd(int line) const;
+    int lineAtIndex(int index) const;
+
+  private:
+    struct Node {
+      bool added = false;
+      int start = 0;
+      int length = 0;
+      int new_lines = 0;
+      int total_length = 0;
+      int total_new_lines = 0;
+      unsigned int priority = 0;
+      int left = -1;
+      int right = -1;
+    };
+
+    const std::u32string& source(const Node& node) const { return node.added ? added_ : original_; }
+    const std::vector<int>& newLines(bool added) const {
+      return added ? added_new_lines_ : original_new_lines_;
+    }
+
+    int countNewLines(bool added, int start, int length) const;
+    int createNode(bool added, int start, int length);
+    void freeTree(int node);
+    void update(int node);
+    void split(int node, int index, int& left, int& right);
+    int merge(int left, int right);
+    bool extendLastPiece(int node, int added_start, int length);
+    void collect(int node, int start, int end, std::u32string& result) const;
+
+    std::u32string original_;
+    std::u32string added_;
+    std::vector<int> original_new_lines_;
+    std::vector<int> added_new_lines_;
+    std::vector<Node> nodes_;
+    std::vector<int> free_nodes_;
+    int root_ = -1;
+    unsigned int random_state_ = 0x9e3779b9;
+  };
+}
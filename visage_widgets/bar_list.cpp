@@ -30,7 +30,17 @@ namespace visage {
     bars_ = std::make_unique<Bar[]>(num_bars);
   }
 
+  void BarList::setYSnapshotSource(TripleBuffer<std::vector<float>>* source) {
+    snapshot_reader_.setSource(source);
+  }
+
   void BarList::draw(Canvas& canvas) {
+    if (const std::vector<float>* values = snapshot_reader_.consume()) {
+      int num_values = std::min<int>(values->size(), num_bars_);
+      for (int i = 0; i < num_values; ++i)
+        bars_[i].top = (*values)[i];
+    }
+
     canvas.setColor(BarColor);
 
     for (int i = 0; i < num_bars_; ++i) {
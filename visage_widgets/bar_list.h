@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include "snapshot_reader.h"
 #include "visage_ui/frame.h"
 
 namespace visage {
@@ -40,6 +41,9 @@ namespace visage {
 
     void draw(Canvas& canvas) override;
 
+    // Reads bar tops published from another thread and applies the latest at draw time.
+    void setYSnapshotSource(TripleBuffer<std::vector<float>>* source);
+
     void setY(int index, float y) {
       bars_[index].top = y;
       redraw();
@@ -55,6 +59,7 @@ namespace visage {
   private:
     std::unique_ptr<Bar[]> bars_;
     int num_bars_ = 0;
+    SnapshotReader snapshot_reader_ { this };
 
     VISAGE_LEAK_CHECKER(BarList)
   };
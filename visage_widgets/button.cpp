@@ -59,9 +59,6 @@ namespace visage {
 
   void Button::draw(Canvas& canvas) {
     draw(canvas, active_ ? hover_amount_.update() : 0.0f);
-
-    if (hover_amount_.isAnimating())
-      redraw();
   }
 
   void Button::mouseEnter(const MouseEvent& e) {
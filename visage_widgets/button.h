@@ -33,9 +33,15 @@
 namespace visage {
   class Button : public Frame {
   public:
-    Button() { hover_amount_.setTargetValue(1.0f); }
+    Button() {
+      hover_amount_.setTargetValue(1.0f);
+      addAnimation(hover_amount_);
+    }
 
-    explicit Button(const std::string& name) : Frame(name) { hover_amount_.setTargetValue(1.0f); }
+    explicit Button(const std::string& name) : Frame(name) {
+      hover_amount_.setTargetValue(1.0f);
+      addAnimation(hover_amount_);
+    }
 
     auto& onToggle() { return on_toggle_; }
 
@@ -55,7 +55,17 @@ namespace visage {
     return height() / 2;
   }
 
+  void GraphLine::setYSnapshotSource(TripleBuffer<std::vector<float>>* source) {
+    snapshot_reader_.setSource(source);
+  }
+
   void GraphLine::draw(Canvas& canvas) {
+    if (const std::vector<float>* values = snapshot_reader_.consume()) {
+      int num_values = std::min<int>(values->size(), line_.num_points);
+      for (int i = 0; i < num_values; ++i)
+        line_.y[i] = (*values)[i];
+    }
+
     if (canvas.totallyClamped())
       return;
 
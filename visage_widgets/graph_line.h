@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include "snapshot_reader.h"
 #include "visage_graphics/line.h"
 #include "visage_graphics/theme.h"
 #include "visage_ui/frame.h"
@@ -58,6 +59,10 @@ namespace visage {
 
     void draw(Canvas& canvas) override;
 
+    // Reads y values published from another thread, e.g. the audio thread. The latest
+    // snapshot is picked up at draw time and the graph only redraws when one arrives.
+    void setYSnapshotSource(TripleBuffer<std::vector<float>>* source);
+
     float boostAt(int index) const { return line_.values[index]; }
     void setBoostAt(int index, float val) {
       VISAGE_ASSERT(index < line_.num_points && index >= 0);
@@ -102,6 +107,7 @@ namespace visage {
 
     Line line_;
     Dimension line_width_;
+    SnapshotReader snapshot_reader_ { this };
 
     bool fill_ = false;
     FillCenter fill_center_ = kCenter;
@@ -448,7 +448,7 @@ namespace visage {
               palette_->removeValue(current_override_id_, value_id);
             else
               palette_->setValue(current_override_id_, value_id, text.toFloat());
-            topParentFrame()->redrawAll();
+            topParentFrame()->redrawThemeDependents(value_id);
           };
 
           text_editors_[index].setBounds(x, y, edit_width, edit_height);
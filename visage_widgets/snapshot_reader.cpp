@@ -0,0 +1,126 @@
+/* Copyright Vital Audio, LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "snapshot_reader.h"
+
+#include "visage_ui/events.h"
+#include "visage_ui/frame.h"
+
+#include <algorithm>
+
+namespace visage {
+  std::vector<SnapshotReader*>& SnapshotReader::waitingReaders() {
+    static std::vector<SnapshotReader*> readers;
+    return readers;
+  }
+
+  void SnapshotReader::postWakeWaitingReaders() {
+    EventManager::instance().addCallback(&SnapshotReader::wakeWaitingReaders);
+  }
+
+  void SnapshotReader::wakeWaitingReaders() {
+    std::vector<SnapshotReader*> readers;
+    std::swap(readers, waitingReaders());
+    for (SnapshotReader* reader : readers) {
+      reader->waiting_ = false;
+      reader->waitForPublish();
+    }
+  }
+
+  SnapshotReader::~SnapshotReader() {
+    listen(false);
+    stopWaiting();
+  }
+
+  void SnapshotReader::setSource(TripleBuffer<std::vector<float>>* source) {
+    stopWaiting();
+    source_ = source;
+    if (source_)
+      source_->setPublishCallback(&SnapshotReader::postWakeWaitingReaders);
+    listen(source_ != nullptr);
+    owner_->redraw();
+  }
+
+  const std::vector<float>* SnapshotReader::consume() {
+    if (source_ == nullptr)
+      return nullptr;
+
+    stopWaiting();
+    listen(true);
+    if (!source_->update())
+      return nullptr;
+    return &source_->readBuffer();
+  }
+
+  bool SnapshotReader::frameClockStep() {
+    if (source_ == nullptr || !owner_->isVisible() || !owner_->isDrawing()) {
+      listening_ = false;
+      return false;
+    }
+
+    if (!source_->hasUpdate()) {
+      if (++quiet_ticks_ < kQuietTicks)
+        return true;
+
+      listening_ = false;
+      waitForPublish();
+      return false;
+    }
+
+    listening_ = false;
+    owner_->redraw();
+    return false;
+  }
+
+  void SnapshotReader::listen(bool listen) {
+    quiet_ticks_ = 0;
+    if (listen == listening_)
+      return;
+
+    listening_ = listen;
+    if (listening_)
+      AnimationManager::instance().addListener(this);
+    else
+      AnimationManager::instance().removeListener(this);
+  }
+
+  void SnapshotReader::waitForPublish() {
+    if (source_->waitForPublish()) {
+      owner_->redraw();
+      return;
+    }
+
+    if (!waiting_) {
+      waiting_ = true;
+      waitingReaders().push_back(this);
+    }
+  }
+
+  void SnapshotReader::stopWaiting() {
+    if (!waiting_)
+      return;
+
+    waiting_ = false;
+    source_->cancelWaitForPublish();
+    std::vector<SnapshotReader*>& readers = waitingReaders();
+    readers.erase(std::find(readers.begin(), readers.end(), this));
+  }
+}
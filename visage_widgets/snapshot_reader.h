@@ -0,0 +1,73 @@
+/* Copyright Vital Audio, LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "visage_ui/animation_manager.h"
+#include "visage_utils/lock_free.h"
+
+#include <vector>
+
+namespace visage {
+  class Frame;
+
+  // Reads values another thread publishes, e.g. the audio thread, for a frame to draw. While a
+  // source is set and the owner is drawing, the reader checks for new snapshots on each frame clock
+  // tick and redraws the owner when one arrives. It then waits for the owner's draw to consume the
+  // snapshot, so a hidden owner does not keep the clock running. After kQuietTicks ticks without a
+  // snapshot the reader leaves the clock and the source's next publish() wakes the UI thread.
+  class SnapshotReader : public FrameClockListener {
+  public:
+    static constexpr int kQuietTicks = 30;
+
+    explicit SnapshotReader(Frame* owner) : owner_(owner) { }
+    ~SnapshotReader() override;
+
+    SnapshotReader(const SnapshotReader&) = delete;
+    SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+    void setSource(TripleBuffer<std::vector<float>>* source);
+    TripleBuffer<std::vector<float>>* source() const { return source_; }
+
+    // Call from the owner's draw. Returns the latest snapshot if a new one arrived since the last
+    // call, otherwise nullptr.
+    const std::vector<float>* consume();
+
+    bool frameClockStep() override;
+    bool isListening() const { return listening_; }
+    bool isWaiting() const { return waiting_; }
+
+  private:
+    static std::vector<SnapshotReader*>& waitingReaders();
+    static void postWakeWaitingReaders();
+    static void wakeWaitingReaders();
+
+    void listen(bool listen);
+    void waitForPublish();
+    void stopWaiting();
+
+    Frame* owner_ = nullptr;
+    TripleBuffer<std::vector<float>>* source_ = nullptr;
+    bool listening_ = false;
+    bool waiting_ = false;
+    int quiet_ticks_ = 0;
+  };
+}
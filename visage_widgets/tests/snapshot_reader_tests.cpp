@@ -0,0 +1,131 @@
+/* Copyright Vital Audio, LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "visage_widgets/snapshot_reader.h"
+#include "visage_ui/events.h"
+#include "visage_ui/frame.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace visage;
+
+TEST_CASE("Snapshot reader listens on the frame clock until a snapshot arrives", "[widgets]") {
+  AnimationManager& manager = AnimationManager::instance();
+  int redraws = 0;
+  FrameEventHandler handler;
+  handler.request_redraw = [&redraws](Frame*) { redraws++; };
+
+  Frame owner;
+  owner.setEventHandler(&handler);
+  TripleBuffer<std::vector<float>> buffer(std::vector<float>(4, 0.0f));
+
+  {
+    SnapshotReader reader(&owner);
+    REQUIRE_FALSE(reader.isListening());
+    REQUIRE_FALSE(manager.isAnimating());
+
+    reader.setSource(&buffer);
+    REQUIRE(redraws == 1);
+    REQUIRE(reader.isListening());
+    REQUIRE(manager.numListeners() == 1);
+
+    manager.advance(1.0);
+    REQUIRE(reader.isListening());
+    REQUIRE(reader.consume() == nullptr);
+
+    buffer.writeBuffer() = { 1.0f, 2.0f, 3.0f, 4.0f };
+    buffer.publish();
+    manager.advance(1.1);
+    REQUIRE_FALSE(reader.isListening());
+    REQUIRE(manager.numListeners() == 0);
+
+    const std::vector<float>* values = reader.consume();
+    REQUIRE(values != nullptr);
+    REQUIRE((*values)[2] == 3.0f);
+    REQUIRE(reader.isListening());
+
+    owner.setVisible(false);
+    manager.advance(1.2);
+    REQUIRE_FALSE(reader.isListening());
+    REQUIRE_FALSE(manager.isAnimating());
+
+    owner.setVisible(true);
+    reader.consume();
+    REQUIRE(reader.isListening());
+  }
+
+  REQUIRE(manager.numListeners() == 0);
+}
+
+TEST_CASE("Snapshot reader stops listening without a source", "[widgets]") {
+  AnimationManager& manager = AnimationManager::instance();
+  Frame owner;
+  TripleBuffer<std::vector<float>> buffer;
+  SnapshotReader reader(&owner);
+
+  reader.setSource(&buffer);
+  REQUIRE(manager.numListeners() == 1);
+
+  reader.setSource(nullptr);
+  REQUIRE_FALSE(reader.isListening());
+  REQUIRE(manager.numListeners() == 0);
+  REQUIRE(reader.consume() == nullptr);
+  REQUIRE_FALSE(reader.isListening());
+}
+
+TEST_CASE("Snapshot reader leaves the frame clock while its source is quiet", "[widgets]") {
+  AnimationManager& manager = AnimationManager::instance();
+  int redraws = 0;
+  FrameEventHandler handler;
+  handler.request_redraw = [&redraws](Frame*) { redraws++; };
+
+  Frame owner;
+  TripleBuffer<std::vector<float>> buffer(std::vector<float>(4, 0.0f));
+  SnapshotReader reader(&owner);
+  reader.setSource(&buffer);
+
+  double time = 1.0;
+  for (int i = 0; i < SnapshotReader::kQuietTicks; ++i) {
+    REQUIRE(manager.isAnimating());
+    manager.advance(time += 0.1);
+  }
+  REQUIRE_FALSE(manager.isAnimating());
+  REQUIRE_FALSE(reader.isListening());
+  REQUIRE(reader.isWaiting());
+
+  owner.setEventHandler(&handler);
+  buffer.writeBuffer() = { 1.0f, 2.0f, 3.0f, 4.0f };
+  buffer.publish();
+  REQUIRE(redraws == 0);
+  REQUIRE(EventManager::instance().hasPendingCallbacks());
+
+  EventManager::instance().checkEventTimers();
+  REQUIRE(redraws == 1);
+  REQUIRE_FALSE(reader.isWaiting());
+
+  const std::vector<float>* values = reader.consume();
+  REQUIRE(values != nullptr);
+  REQUIRE((*values)[3] == 4.0f);
+  REQUIRE(reader.isListening());
+
+  buffer.publish();
+  REQUIRE_FALSE(EventManager::instance().hasPendingCallbacks());
+}
@@ -0,0 +1,126 @@
+/* Copyright Vital Audio, LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "visage_widgets/virtual_list.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace visage;
+
+namespace {
+  class TestSource : public VirtualList::DataSource {
+  public:
+    int numItems() const override { return heights.size(); }
+    float rowHeight(int row) const override { return heights[row]; }
+    std::unique_ptr<Frame> createItem() override {
+      created++;
+      return std::make_unique<Frame>();
+    }
+    void bindItem(Frame& item, int index) override { bound[&item] = index; }
+
+    std::vector<float> heights;
+    std::map<const Frame*, int> bound;
+    int created = 0;
+  };
+}
+
+TEST_CASE("Virtual list row offsets", "[widgets]") {
+  TestSource source;
+  source.heights = { 10.0f, 20.0f, 30.0f, 40.0f };
+  VirtualList list;
+  list.setDataSource(&source);
+
+  REQUIRE(list.numRows() == 4);
+  REQUIRE(list.rowOffset(0) == 0.0f);
+  REQUIRE(list.rowOffset(2) == 30.0f);
+  REQUIRE(list.rowOffset(4) == 100.0f);
+
+  REQUIRE(list.rowAtOffset(-5.0f) == 0);
+  REQUIRE(list.rowAtOffset(9.5f) == 0);
+  REQUIRE(list.rowAtOffset(10.0f) == 1);
+  REQUIRE(list.rowAtOffset(29.5f) == 1);
+  REQUIRE(list.rowAtOffset(30.0f) == 2);
+  REQUIRE(list.rowAtOffset(99.0f) == 3);
+  REQUIRE(list.rowAtOffset(1000.0f) == 3);
+}
+
+TEST_CASE("Virtual list recycles items while scrolling", "[widgets]") {
+  TestSource source;
+  source.heights.assign(100, 10.0f);
+  VirtualList list;
+  list.setBounds(0, 0, 100, 50);
+  list.setDataSource(&source);
+
+  int visible = list.numVisibleItems();
+  REQUIRE(visible == 7);
+  REQUIRE(list.numCreatedItems() == visible);
+  REQUIRE(list.numPooledItems() == 0);
+
+  list.setYPosition(500.0f);
+  REQUIRE(list.itemFrame(0) == nullptr);
+  REQUIRE(list.itemFrame(50) != nullptr);
+  REQUIRE(list.numCreatedItems() == source.created);
+  REQUIRE(source.created == list.numVisibleItems());
+
+  for (int i = 49; i <= 56; ++i) {
+    Frame* item = list.itemFrame(i);
+    REQUIRE(item != nullptr);
+    REQUIRE(item->isVisible());
+    REQUIRE(source.bound[item] == i);
+    REQUIRE(item->y() == i * 10.0f);
+  }
+
+  int created = source.created;
+  list.setYPosition(0.0f);
+  REQUIRE(source.created == created);
+  REQUIRE(list.numVisibleItems() == visible);
+  REQUIRE(list.numPooledItems() == created - visible);
+  REQUIRE(list.numCreatedItems() == list.numVisibleItems() + list.numPooledItems());
+  REQUIRE(source.bound[list.itemFrame(0)] == 0);
+}
+
+TEST_CASE("Virtual list follows row height changes", "[widgets]") {
+  TestSource source;
+  source.heights.assign(10, 10.0f);
+  VirtualList list;
+  list.setBounds(0, 0, 100, 50);
+  list.setDataSource(&source);
+  REQUIRE(list.scrollableHeight() == 100.0f);
+
+  source.heights[0] = 30.0f;
+  list.reloadData();
+  REQUIRE(list.rowOffset(1) == 30.0f);
+  REQUIRE(list.rowOffset(10) == 120.0f);
+  REQUIRE(list.scrollableHeight() == 120.0f);
+  REQUIRE(list.rowAtOffset(25.0f) == 0);
+
+  Frame* first = list.itemFrame(0);
+  Frame* second = list.itemFrame(1);
+  REQUIRE(first->height() == 30.0f);
+  REQUIRE(second->y() == 30.0f);
+  REQUIRE(list.itemFrame(5) == nullptr);
+
+  source.heights.resize(3);
+  list.reloadData();
+  REQUIRE(list.numRows() == 3);
+  REQUIRE(list.numVisibleItems() == 3);
+  REQUIRE(list.itemFrame(3) == nullptr);
+}
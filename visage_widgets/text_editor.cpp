@@ -99,9 +99,6 @@ namespace visage {
   }
 
   TextEditor::TextEditor(const std::string& name) : ScrollableFrame(name) {
-    undo_history_.reserve(kMaxUndoHistory);
-    undone_history_.reserve(kMaxUndoHistory);
-
     setAcceptsKeystrokes(true);
     text_.setFont(Font(10, fonts::Lato_Regular_ttf));
     default_text_.setFont(Font(10, fonts::Lato_Regular_ttf));
@@ -115,10 +112,11 @@ namespace visage {
   }
 
   void TextEditor::selectionRectangle(Canvas& canvas, float x, float y, float w, float h) const {
+    float view_height = scrolledContentBounds().height();
     float left = std::max(0.0f, std::min(width(), x));
-    float top = std::max(0.0f, std::min(height(), y));
+    float top = std::max(0.0f, std::min(view_height, y));
     float right = std::max(0.0f, std::min(width(), x + w));
-    float bottom = std::max(0.0f, std::min(height(), y + h));
+    float bottom = std::max(0.0f, std::min(view_height, y + h));
     canvas.rectangle(left, top, right - left, bottom - top);
   }
 
@@ -138,6 +136,7 @@ namespace visage {
       int num_lines = line_breaks_.size() + 1;
       y_offset = (height() - num_lines * line_height) * 0.5f - yPosition();
     }
+    y_offset += yPosition() - scrolledContentBounds().y();
 
     canvas.setColor(TextEditorCaret);
     if (caret_position_ == selection_start)
@@ -171,6 +170,10 @@ namespace visage {
 
   void TextEditor::draw(Canvas& canvas) {
     drawBackground(canvas);
+  }
+
+  void TextEditor::drawScrolledContent(Canvas& canvas) {
+    float view_top = scrolledContentBounds().y();
     float x_margin = xMargin();
     Bounds text_bounds(x_margin, 0.0f, width() - 2.0f * x_margin, std::max(height(), scrollableHeight()));
 
@@ -178,46 +181,122 @@ namespace visage {
       drawSelection(canvas);
 
     canvas.setPosition(0, yMargin());
-    if (text_.text().isEmpty()) {
+    if (buffer_.isEmpty()) {
       bool center = (justification() & Font::kLeft) == 0 && (justification() & Font::kRight) == 0;
       if (!default_text_.text().isEmpty() && (!center || !hasKeyboardFocus())) {
         canvas.setColor(TextEditorDefaultText);
-        canvas.text(&default_text_, x_margin - x_position_, -yPosition(),
+        canvas.text(&default_text_, x_margin - x_position_, -view_top,
                     x_position_ + text_bounds.width(), text_bounds.height());
       }
+      return;
     }
+
+    // Only the visible run of the buffer is laid out, placed where the full text would put it
+    Text* text = &visible_text_;
+    float text_y = -view_top;
+    float text_height = text_bounds.height();
+    int horizontal = justification() & (Font::kLeft | Font::kRight);
+    visible_text_.setFont(text_.font());
+    visible_text_.setMultiLine(text_.multiLine());
+    visible_text_.setCharacterOverride(text_.characterOverride());
+    canvas.setColor(TextEditorText);
+
+    if (!text_.multiLine()) {
+      const std::vector<double>& advances = lineAdvances(0);
+      int length = advances.size() - 1;
+      float line_x = indexToPosition(0).first;
+      int start = Font::prefixOverflowIndex(advances, 0, length, x_position_ - line_x);
+      int end = Font::prefixOverflowIndex(advances, 0, length, x_position_ + width() - line_x);
+      start = std::max(0, start - 1);
+      end = std::min(length, end + 2);
+
+      int vertical = justification() & (Font::kTop | Font::kBottom);
+      visible_text_.setText(buffer_.substring(start, end - start));
+      visible_text_.setJustification(static_cast<Font::Justification>(Font::kLeft | vertical));
+      canvas.text(text, line_x + advances[start] - x_position_, text_y,
+                  advances[end] - advances[start], text_height);
+      return;
+    }
+
+    std::pair<int, int> lines = visibleLines();
+    float line_height = font().lineHeight();
+    int start = lineRange(lines.first).first;
+    int end = lines.second < line_breaks_.size() ? line_breaks_[lines.second] : textLength();
+    visible_text_.setText(buffer_.substring(start, end - start));
+    visible_text_.setJustification(static_cast<Font::Justification>(Font::kTop | horizontal));
+    text_y += textBlockTop() + lines.first * line_height;
+    text_height = (lines.second - lines.first + 1) * line_height;
+
+    if (justification() & Font::kLeft)
+      canvas.text(text, x_margin - x_position_, text_y, x_position_ + text_bounds.width(), text_height);
+    else if (justification() & Font::kRight)
+      canvas.text(text, 0, text_y, x_margin + text_bounds.width() - x_position_, text_height);
     else {
-      canvas.setColor(TextEditorText);
-      if (justification() & Font::kLeft) {
-        canvas.text(&text_, x_margin - x_position_, -yPosition(), x_position_ + text_bounds.width(),
-                    text_bounds.height());
-      }
-      else if (justification() & Font::kRight) {
-        canvas.text(&text_, 0, -yPosition(), x_margin + text_bounds.width() - x_position_,
-                    text_bounds.height());
-      }
-      else {
-        canvas.setPosition(-x_position_, 0.0f);
-        float expansion = std::abs(x_position_);
-        canvas.text(&text_, -expansion, -yPosition(), text_bounds.width() + 2 * expansion,
-                    text_bounds.height());
-      }
+      canvas.setPosition(-x_position_, 0.0f);
+      float expansion = std::abs(x_position_);
+      canvas.text(text, -expansion, text_y, text_bounds.width() + 2 * expansion, text_height);
     }
   }
 
-  std::pair<float, float> TextEditor::indexToPosition(int index) const {
-    int line = 0;
+  float TextEditor::textBlockTop() const {
+    if (justification() & Font::kTop)
+      return 0.0f;
+
+    float bounds_height = std::max(height(), scrollableHeight());
+    float block_height = (line_breaks_.size() + 1) * font().lineHeight();
+    if (justification() & Font::kBottom)
+      return bounds_height - block_height;
+    return 0.5f * (bounds_height - block_height);
+  }
+
+  std::pair<int, int> TextEditor::visibleLines() const {
+    Bounds view = scrolledContentBounds();
     float line_height = font().lineHeight();
+    int last_line = line_breaks_.size();
+    if (line_height <= 0.0f)
+      return { 0, last_line };
+
+    float top = yMargin() + textBlockTop();
+    int first = std::floor((view.y() - top) / line_height);
+    int last = std::ceil((view.bottom() - top) / line_height);
+    return { std::max(0, std::min(first, last_line)), std::max(0, std::min(last, last_line)) };
+  }
+
+  const std::vector<double>& TextEditor::lineAdvances(int line) const {
+    static constexpr int kMaxCachedLines = 256;
+
+    if (line_advances_font_ != font().packedFont() ||
+        line_advances_override_ != text_.characterOverride()) {
+      line_advances_.clear();
+      line_advances_font_ = font().packedFont();
+      line_advances_override_ = text_.characterOverride();
+    }
 
-    while (line < line_breaks_.size() && index >= line_breaks_[line])
-      line++;
+    auto cached = line_advances_.find(line);
+    if (cached != line_advances_.end())
+      return cached->second;
+
+    if (line_advances_.size() >= kMaxCachedLines)
+      line_advances_.clear();
+
+    std::pair<int, int> range = lineRange(line);
+    std::u32string line_text = buffer_.substring(range.first, range.second - range.first);
+    std::vector<double> advances = font().prefixAdvances(line_text.c_str(), line_text.length(),
+                                                         text_.characterOverride());
+    return line_advances_[line] = std::move(advances);
+  }
+
+  std::pair<float, float> TextEditor::indexToPosition(int index) const {
+    float line_height = font().lineHeight();
+    int line = std::upper_bound(line_breaks_.begin(), line_breaks_.end(), index) - line_breaks_.begin();
 
     std::pair<int, int> range = lineRange(line);
+    const std::vector<double>& advances = lineAdvances(line);
+    int line_length = advances.size() - 1;
 
-    float pre_width = font().stringWidth(text_.text().c_str() + range.first, index - range.first,
-                                         text_.characterOverride());
-    float full_width = font().stringWidth(text_.text().c_str() + range.first,
-                                          range.second - range.first, text_.characterOverride());
+    int line_index = std::max(0, std::min(index - range.first, line_length));
+    float pre_width = advances[line_index];
+    float full_width = advances.back();
 
     float line_x = (width() - full_width) / 2.0f;
     float x_margin = xMargin();
@@ -239,7 +318,7 @@ namespace visage {
     if (line < line_breaks_.size()) {
       end_index = line_breaks_[line];
 
-      if (Font::isNewLine(text_.text()[end_index - 1]))
+      if (Font::isNewLine(buffer_.at(end_index - 1)))
         end_index--;
     }
 
@@ -250,9 +329,9 @@ namespace visage {
     float line_height = font().lineHeight();
     int line = std::min<int>(line_breaks_.size(), (position.second - yMargin()) / line_height);
     std::pair<int, int> range = lineRange(line);
-
-    float full_width = font().stringWidth(text_.text().c_str() + range.first,
-                                          range.second - range.first, text_.characterOverride());
+    const std::vector<double>& advances = lineAdvances(line);
+    int line_length = advances.size() - 1;
+    float full_width = advances.back();
 
     float line_x = (width() - full_width) * 0.5f;
     float x_margin = xMargin();
@@ -261,8 +340,7 @@ namespace visage {
     else if (justification() & Font::kRight)
       line_x = width() - x_margin - full_width;
 
-    int index = font().widthOverflowIndex(text_.text().c_str() + range.first, range.second - range.first,
-                                          position.first - line_x, true, text_.characterOverride());
+    int index = Font::prefixOverflowIndex(advances, 0, line_length, position.first - line_x, true);
     return std::min(range.first + index, range.second);
   }
 
@@ -307,11 +385,9 @@ namespace visage {
       addUndoPosition();
     action_state_ = kDeleting;
 
-    String before = text_.text().substring(0, selectionStart());
-    String after = text_.text().substring(selectionEnd());
-    text_.setText(before + after);
-    setLineBreaks();
-    caret_position_ = selectionStart();
+    int start = selectionStart();
+    replaceText(start, selectionEnd() - start, U"");
+    caret_position_ = start;
     selection_position_ = caret_position_;
     makeCaretVisible();
 
@@ -333,7 +409,7 @@ namespace visage {
         setYPosition(caret_location.second - height() + font().lineHeight());
     }
     else {
-      float line_width = font().stringWidth(text_.text().c_str(), textLength(), text_.characterOverride());
+      float line_width = lineAdvances(0).back();
       float x_margin = xMarginSize();
       float min_view = x_position_ + x_margin;
       float max_view = x_position_ + width() - x_margin;
@@ -368,7 +444,34 @@ namespace visage {
     setViewBounds();
     selection_start_point_ = indexToPosition(selectionStart());
     selection_end_point_ = indexToPosition(selectionEnd());
-    redraw();
+    redrawScrolledContent();
+  }
+
+  void TextEditor::updateLineBreaks(int index, int removed, int inserted) {
+    if (!text_.multiLine() || text_.font().packedFont() == nullptr) {
+      line_advances_.clear();
+      return;
+    }
+
+    // Only the hard lines touched by the edit are wrapped again, later breaks shift by the change
+    int delta = inserted - removed;
+    int start = buffer_.lineStart(buffer_.lineAtIndex(index));
+    int end = buffer_.lineEnd(buffer_.lineAtIndex(index + inserted));
+
+    auto first = std::upper_bound(line_breaks_.begin(), line_breaks_.end(), start);
+    int first_line = first - line_breaks_.begin();
+    line_advances_.erase(line_advances_.lower_bound(first_line), line_advances_.end());
+    auto last = std::upper_bound(first, line_breaks_.end(), end - delta);
+    for (auto it = last; it != line_breaks_.end(); ++it)
+      *it += delta;
+
+    std::u32string lines = buffer_.substring(start, end - start);
+    std::vector<int> breaks = font().lineBreaks(lines.c_str(), lines.length(), width() - 2 * xMargin());
+    for (int& line_break : breaks)
+      line_break += start;
+
+    auto position = line_breaks_.erase(first, last);
+    line_breaks_.insert(position, breaks.begin(), breaks.end());
   }
 
   void TextEditor::setViewBounds() {
@@ -380,12 +483,12 @@ namespace visage {
   String TextEditor::selection() const {
     int start = selectionStart();
     int end = selectionEnd();
-    return text_.text().substring(start, end - start);
+    return buffer_.substring(start, end - start);
   }
 
   int TextEditor::beginningOfWord() const {
     int index = caret_position_ - 1;
-    while (index > 0 && isVariableCharacter(text_.text()[index - 1]))
+    while (index > 0 && isVariableCharacter(buffer_.at(index - 1)))
       --index;
     return std::max(0, index);
   }
@@ -393,7 +496,7 @@ namespace visage {
   int TextEditor::endOfWord() const {
     int string_length = textLength();
     int index = caret_position_ + 1;
-    while (index < string_length && isVariableCharacter(text_.text()[index]))
+    while (index < string_length && isVariableCharacter(buffer_.at(index)))
       ++index;
     return std::min(string_length, index);
   }
@@ -421,7 +524,7 @@ namespace visage {
       makeCaretVisible();
     }
 
-    redraw();
+    redrawScrolledContent();
   }
 
   void TextEditor::mouseUp(const MouseEvent& e) {
@@ -432,7 +535,7 @@ namespace visage {
     if (!mouse_focus_)
       caret_position_ = positionToIndex({ e.position.x + x_position_, e.position.y + yPosition() });
     makeCaretVisible();
-    redraw();
+    redrawScrolledContent();
   }
 
   void TextEditor::doubleClick(const MouseEvent& e) {
@@ -492,7 +595,7 @@ namespace visage {
   }
 
   bool TextEditor::keyPress(const KeyEvent& key) {
-    redraw();
+    redrawScrolledContent();
 
     bool modifier = key.isMainModifier();
     if (key.isAltDown()) {
@@ -613,7 +716,7 @@ namespace visage {
   }
 
   void TextEditor::focusChanged(bool is_focused, bool was_clicked) {
-    redraw();
+    redrawScrolledContent();
     if (!is_focused) {
       if (dead_key_entry_ != DeadKey::None) {
         dead_key_entry_ = DeadKey::None;
@@ -801,16 +904,26 @@ namespace visage {
   }
 
   bool TextEditor::undo() {
+    while (!undo_history_.empty() && undo_history_.back().edits.empty())
+      undo_history_.pop_back();
     if (undo_history_.empty())
       return false;
 
-    undone_history_.emplace_back(text_.text(), caret_position_);
-    std::pair<String, int> state = undo_history_.back();
+    UndoStep step = std::move(undo_history_.back());
     undo_history_.pop_back();
-    text_.setText(state.first);
-    caret_position_ = state.second;
-    selection_position_ = state.second;
-    setLineBreaks();
+    undo_bytes_ -= step.bytes;
+    for (auto it = step.edits.rbegin(); it != step.edits.rend(); ++it) {
+      buffer_.erase(it->index, it->inserted.size());
+      buffer_.insert(it->index, it->removed);
+      updateLineBreaks(it->index, it->inserted.size(), it->removed.size());
+    }
+    text_dirty_ = true;
+
+    step.undone_caret_position = caret_position_;
+    caret_position_ = step.caret_position;
+    selection_position_ = caret_position_;
+    action_state_ = kNone;
+    undone_history_.push_back(std::move(step));
     makeCaretVisible();
     on_text_change_.callback();
     return true;
@@ -820,13 +933,20 @@ namespace visage {
     if (undone_history_.empty())
       return false;
 
-    addUndoPosition();
-    std::pair<String, int> state = undone_history_.back();
+    UndoStep step = std::move(undone_history_.back());
     undone_history_.pop_back();
-    text_.setText(state.first);
-    caret_position_ = state.second;
-    selection_position_ = state.second;
-    setLineBreaks();
+    for (const UndoEdit& edit : step.edits) {
+      buffer_.erase(edit.index, edit.removed.size());
+      buffer_.insert(edit.index, edit.inserted);
+      updateLineBreaks(edit.index, edit.removed.size(), edit.inserted.size());
+    }
+    text_dirty_ = true;
+
+    caret_position_ = step.undone_caret_position;
+    selection_position_ = caret_position_;
+    action_state_ = kNone;
+    undo_bytes_ += step.bytes;
+    undo_history_.push_back(std::move(step));
     makeCaretVisible();
     on_text_change_.callback();
     return true;
@@ -847,21 +967,64 @@ namespace visage {
       addUndoPosition();
     action_state_ = kInserting;
 
-    String before = text_.text().substring(0, selectionStart());
-    String after = text_.text().substring(selectionEnd());
+    int start = selectionStart();
+    int removed = selectionEnd() - start;
     int max_text = text.length();
     if (max_characters_)
-      max_text = std::max(0, std::min<int>(max_text, max_characters_ - before.length() - after.length()));
+      max_text = std::max(0, std::min<int>(max_text, max_characters_ - textLength() + removed));
 
-    String trimmed = text.substring(0, max_text);
-    text_.setText(before + trimmed + after);
-    setLineBreaks();
-    caret_position_ = before.length() + max_text;
+    replaceText(start, removed, text.substring(0, max_text).toUtf32());
+    caret_position_ = start + max_text;
     selection_position_ = caret_position_;
     makeCaretVisible();
 
     on_text_change_.callback();
-    redraw();
+    redrawScrolledContent();
+  }
+
+  void TextEditor::addUndoPosition() {
+    undo_history_.emplace_back();
+    undo_history_.back().caret_position = caret_position_;
+  }
+
+  void TextEditor::recordEdit(int index, const std::u32string& removed, const std::u32string& inserted) {
+    if (undo_history_.empty())
+      addUndoPosition();
+
+    // Consecutive typing and deleting extend the previous edit instead of adding a new one
+    UndoStep& step = undo_history_.back();
+    size_t bytes = (removed.size() + inserted.size()) * sizeof(char32_t);
+    UndoEdit* last = step.edits.empty() ? nullptr : &step.edits.back();
+    if (last && removed.empty() && last->index + static_cast<int>(last->inserted.size()) == index)
+      last->inserted += inserted;
+    else if (last && inserted.empty() && last->inserted.empty() && index + static_cast<int>(removed.size()) == last->index) {
+      last->removed = removed + last->removed;
+      last->index = index;
+    }
+    else if (last && inserted.empty() && last->inserted.empty() && index == last->index)
+      last->removed += removed;
+    else {
+      step.edits.push_back({ index, removed, inserted });
+      bytes += sizeof(UndoEdit);
+    }
+
+    step.bytes += bytes;
+    undo_bytes_ += bytes;
+    while (undo_bytes_ > kMaxUndoBytes && undo_history_.size() > 1) {
+      undo_bytes_ -= undo_history_.front().bytes;
+      undo_history_.pop_front();
+    }
+  }
+
+  void TextEditor::replaceText(int index, int length, const std::u32string& text) {
+    if (length == 0 && text.empty())
+      return;
+
+    recordEdit(index, buffer_.substring(index, length), text);
+    buffer_.erase(index, length);
+    buffer_.insert(index, text);
+    text_dirty_ = true;
+    updateLineBreaks(index, length, text.size());
   }
 
   void TextEditor::setNumberEntry() {
@@ -25,12 +25,16 @@
 #include "visage_graphics/font.h"
 #include "visage_ui/frame.h"
 #include "visage_ui/scroll_bar.h"
+#include "visage_utils/text_buffer.h"
+
+#include <deque>
+#include <map>
 
 namespace visage {
   class TextEditor : public ScrollableFrame {
   public:
     static constexpr int kDefaultPasswordCharacter = '*';
-    static constexpr int kMaxUndoHistory = 1000;
+    static constexpr size_t kMaxUndoBytes = 4 * 1024 * 1024;
 
     static constexpr char32_t kAcuteAccentCharacter = U'\u00B4';
     static constexpr char32_t kGraveAccentCharacter = U'\u0060';
@@ -84,9 +88,12 @@ namespace visage {
     void selectionRectangle(Canvas& canvas, float x, float y, float w, float h) const;
     void drawSelection(Canvas& canvas) const;
     void draw(Canvas& canvas) override;
+    void drawScrolledContent(Canvas& canvas) override;
 
     std::pair<float, float> indexToPosition(int index) const;
     std::pair<int, int> lineRange(int line) const;
+    float textBlockTop() const;
+    std::pair<int, int> visibleLines() const;
     int positionToIndex(const std::pair<float, float>& position) const;
 
     void cancel();
@@ -184,19 +191,31 @@ namespace visage {
     }
 
     void setLineBreaks() {
+      line_advances_.clear();
       if (text_.multiLine() && text_.font().packedFont()) {
-        line_breaks_ = text_.font().lineBreaks(text_.text().c_str(), text_.text().length(),
-                                               width() - 2 * xMargin());
+        line_breaks_.clear();
+        for (int line = 0; line < buffer_.numLines(); ++line) {
+          int start = buffer_.lineStart(line);
+          std::u32string text = buffer_.substring(start, buffer_.lineEnd(line) - start);
+          float wrap_width = width() - 2 * xMargin();
+          for (int line_break : text_.font().lineBreaks(text.c_str(), text.length(), wrap_width))
+            line_breaks_.push_back(start + line_break);
+        }
       }
     }
+    void updateLineBreaks(int index, int removed, int inserted);
 
     void setText(const String& text) {
       if (max_characters_)
-        text_.setText(text.substring(0, max_characters_));
+        setBufferText(text.substring(0, max_characters_));
       else
-        text_.setText(text);
-      caret_position_ = text_.text().length();
+        setBufferText(text);
+      caret_position_ = buffer_.length();
       selection_position_ = caret_position_;
+      undo_history_.clear();
+      undone_history_.clear();
+      undo_bytes_ = 0;
+      action_state_ = kNone;
       setLineBreaks();
       makeCaretVisible();
     }
@@ -205,8 +224,10 @@ namespace visage {
     void setDefaultText(const String& default_text) { default_text_.setText(default_text); }
     void setMaxCharacters(int max) { max_characters_ = max; }
     void setMultiLine(bool multi_line) {
+      line_advances_.clear();
       text_.setMultiLine(multi_line);
       default_text_.setMultiLine(multi_line);
+      setScrollCaching(multi_line);
       if (multi_line)
         x_position_ = 0;
     }
@@ -226,27 +247,66 @@ namespace visage {
     void setNumberEntry();
     void setTextFieldEntry();
 
-    const String& text() const { return text_.text(); }
-    int textLength() const { return text_.text().length(); }
+    const String& text() const {
+      syncText();
+      return text_.text();
+    }
+    int textLength() const { return buffer_.length(); }
     const Font& font() const { return text_.font(); }
     Font::Justification justification() const { return text_.justification(); }
     void setBackgroundColorId(theme::ColorId color_id) { background_color_id_ = color_id; }
 
   private:
+    struct UndoEdit {
+      int index = 0;
+      std::u32string removed;
+      std::u32string inserted;
+    };
+
+    struct UndoStep {
+      std::vector<UndoEdit> edits;
+      int caret_position = 0;
+      int undone_caret_position = 0;
+      size_t bytes = 0;
+    };
+
+    // Prefix advances of recently measured lines so caret moves and hit tests are a lookup and a
+    // binary search. Edits drop the lines from the edited paragraph on.
+    const std::vector<double>& lineAdvances(int line) const;
+
     float xMarginSize() const {
       return set_x_margin_ ? set_x_margin_ : paletteValue(TextEditorMarginX);
     }
-    void addUndoPosition() { undo_history_.emplace_back(text_.text(), caret_position_); }
+    void addUndoPosition();
+    void recordEdit(int index, const std::u32string& removed, const std::u32string& inserted);
+    void replaceText(int index, int length, const std::u32string& text);
+    void setBufferText(const String& text) {
+      buffer_.setText(text.toUtf32());
+      text_dirty_ = true;
+      line_advances_.clear();
+    }
+    void syncText() const {
+      if (text_dirty_) {
+        text_.setText(buffer_.toString());
+        text_dirty_ = false;
+      }
+    }
 
     CallbackList<void()> on_text_change_;
     CallbackList<void()> on_enter_key_;
     CallbackList<void()> on_escape_key_;
 
     DeadKey dead_key_entry_ = DeadKey::None;
-    Text text_;
+    TextBuffer buffer_;
+    mutable Text text_;
+    mutable bool text_dirty_ = false;
     Text default_text_;
+    Text visible_text_;
     std::string filtered_characters_;
     std::vector<int> line_breaks_;
+    mutable std::map<int, std::vector<double>> line_advances_;
+    mutable const PackedFont* line_advances_font_ = nullptr;
+    mutable int line_advances_override_ = 0;
     int caret_position_ = 0;
     int selection_position_ = 0;
     std::pair<float, float> selection_start_point_;
@@ -264,8 +324,9 @@ namespace visage {
     float x_position_ = 0.0f;
 
     ActionState action_state_ = kNone;
-    std::vector<std::pair<String, int>> undo_history_;
-    std::vector<std::pair<String, int>> undone_history_;
+    std::deque<UndoStep> undo_history_;
+    std::vector<UndoStep> undone_history_;
+    size_t undo_bytes_ = 0;
 
     VISAGE_LEAK_CHECKER(TextEditor)
   };
@@ -0,0 +1,146 @@
+/* Copyright Vital Audio, LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "virtual_list.h"
+
+namespace visage {
+  VirtualList::VirtualList(const std::string& name) : ScrollableFrame(name) {
+    onScroll() += [this](ScrollableFrame*) { updateVisibleItems(false); };
+  }
+
+  void VirtualList::resized() {
+    ScrollableFrame::resized();
+    setScrollableHeight(row_offsets_.empty() ? 0.0f : row_offsets_.back(), height());
+    updateVisibleItems(false);
+  }
+
+  void VirtualList::reloadData() {
+    row_offsets_.clear();
+    if (data_source_) {
+      int num_columns = std::max(1, data_source_->numColumns());
+      int num_rows = (data_source_->numItems() + num_columns - 1) / num_columns;
+      row_offsets_.reserve(num_rows + 1);
+      row_offsets_.push_back(0.0f);
+      for (int row = 0; row < num_rows; ++row)
+        row_offsets_.push_back(row_offsets_.back() + data_source_->rowHeight(row));
+    }
+
+    setScrollableHeight(row_offsets_.empty() ? 0.0f : row_offsets_.back(), height());
+    updateVisibleItems(true);
+  }
+
+  void VirtualList::refreshItem(int index) {
+    Frame* item = itemFrame(index);
+    if (item == nullptr)
+      return;
+
+    data_source_->bindItem(*item, index);
+    item->redraw();
+  }
+
+  int VirtualList::rowAtOffset(float y) const {
+    if (numRows() == 0)
+      return -1;
+
+    auto it = std::upper_bound(row_offsets_.begin(), row_offsets_.end(), y);
+    int row = static_cast<int>(it - row_offsets_.begin()) - 1;
+    return std::max(0, std::min(numRows() - 1, row));
+  }
+
+  int VirtualList::itemAtPosition(Point position) const {
+    if (data_source_ == nullptr || numRows() == 0 || width() <= 0.0f)
+      return -1;
+
+    float y = position.y + yPosition();
+    if (y < 0.0f || y >= row_offsets_.back())
+      return -1;
+
+    int num_columns = std::max(1, data_source_->numColumns());
+    int column = std::max(0, std::min(num_columns - 1, static_cast<int>(position.x * num_columns / width())));
+    int index = rowAtOffset(y) * num_columns + column;
+    return index < data_source_->numItems() ? index : -1;
+  }
+
+  Frame* VirtualList::itemFrame(int index) const {
+    auto it = visible_items_.find(index);
+    return it == visible_items_.end() ? nullptr : it->second;
+  }
+
+  void VirtualList::recycle(std::map<int, Frame*>::iterator it) {
+    it->second->setVisible(false);
+    free_items_.push_back(it->second);
+    visible_items_.erase(it);
+  }
+
+  void VirtualList::updateVisibleItems(bool rebind) {
+    if (data_source_ == nullptr || numRows() == 0 || height() <= 0.0f) {
+      while (!visible_items_.empty())
+        recycle(visible_items_.begin());
+      return;
+    }
+
+    int num_items = data_source_->numItems();
+    int num_columns = std::max(1, data_source_->numColumns());
+    int first_row = std::max(0, rowAtOffset(yPosition()) - kOverscanRows);
+    int last_row = std::min(numRows() - 1, rowAtOffset(yPosition() + height()) + kOverscanRows);
+    int first_index = first_row * num_columns;
+    int last_index = std::min(num_items - 1, (last_row + 1) * num_columns - 1);
+
+    for (auto it = visible_items_.begin(); it != visible_items_.end();) {
+      auto next = std::next(it);
+      if (it->first < first_index || it->first > last_index)
+        recycle(it);
+      it = next;
+    }
+
+    float column_width = width() / num_columns;
+    for (int index = first_index; index <= last_index; ++index) {
+      auto it = visible_items_.find(index);
+      Frame* item = nullptr;
+      bool bind = rebind;
+      if (it != visible_items_.end())
+        item = it->second;
+      else {
+        bind = true;
+        if (free_items_.empty()) {
+          items_.push_back(data_source_->createItem());
+          item = items_.back().get();
+          addScrolledChild(item);
+        }
+        else {
+          item = free_items_.back();
+          free_items_.pop_back();
+          item->setVisible(true);
+        }
+        visible_items_[index] = item;
+      }
+
+      int row = index / num_columns;
+      int column = index % num_columns;
+      item->setBounds(column * column_width, row_offsets_[row], column_width,
+                      row_offsets_[row + 1] - row_offsets_[row]);
+      if (bind) {
+        data_source_->bindItem(*item, index);
+        item->redraw();
+      }
+    }
+  }
+}
@@ -0,0 +1,81 @@
+/* Copyright Vital Audio, LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "visage_ui/scroll_bar.h"
+
+#include <map>
+
+namespace visage {
+  class VirtualList : public ScrollableFrame {
+  public:
+    static constexpr int kOverscanRows = 1;
+
+    class DataSource {
+    public:
+      virtual ~DataSource() = default;
+
+      virtual int numItems() const = 0;
+      virtual int numColumns() const { return 1; }
+      virtual float rowHeight(int row) const = 0;
+      virtual std::unique_ptr<Frame> createItem() = 0;
+      virtual void bindItem(Frame& item, int index) = 0;
+    };
+
+    explicit VirtualList(const std::string& name = "");
+    ~VirtualList() override = default;
+
+    void resized() override;
+
+    void setDataSource(DataSource* data_source) {
+      data_source_ = data_source;
+      reloadData();
+    }
+    DataSource* dataSource() const { return data_source_; }
+
+    // Call after the item count or row heights change; rebinds every visible item
+    void reloadData();
+    void refreshItem(int index);
+
+    int numRows() const { return std::max(0, static_cast<int>(row_offsets_.size()) - 1); }
+    float rowOffset(int row) const { return row_offsets_[row]; }
+    int rowAtOffset(float y) const;
+    int itemAtPosition(Point position) const;
+    Frame* itemFrame(int index) const;
+
+    int numCreatedItems() const { return items_.size(); }
+    int numPooledItems() const { return free_items_.size(); }
+    int numVisibleItems() const { return visible_items_.size(); }
+
+  private:
+    void updateVisibleItems(bool rebind);
+    void recycle(std::map<int, Frame*>::iterator it);
+
+    DataSource* data_source_ = nullptr;
+    std::vector<float> row_offsets_;
+    std::vector<std::unique_ptr<Frame>> items_;
+    std::vector<Frame*> free_items_;
+    std::map<int, Frame*> visible_items_;
+
+    VISAGE_LEAK_CHECKER(VirtualList)
+  };
+}
@@ -65,6 +65,9 @@ namespace visage {
         text.c_str());
   }
 
+  // The main loop already runs every animation frame and can't be woken early from here
+  void wakeEventLoop() { }
+
   std::string cursorString(MouseCursor cursor) {
     switch (cursor) {
     case MouseCursor::Arrow: return "default";
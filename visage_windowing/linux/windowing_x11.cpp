@@ -24,8 +24,17 @@
 
 #include "visage_utils/thread_utils.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
 #include <cstring>
+#include <poll.h>
 #include <sstream>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <thread>
+#include <unistd.h>
 #include <X11/cursorfont.h>
 #include <X11/extensions/Xrandr.h>
 #include <X11/Xutil.h>
@@ -60,6 +69,8 @@ namespace visage {
       return it != native_window_lookup_.end() ? it->second : nullptr;
     }
 
+    const std::map<void*, WindowX11*>& windows() const { return native_window_lookup_; }
+
   private:
     NativeWindowLookup() = default;
     ~NativeWindowLookup() = default;
@@ -67,6 +78,116 @@ namespace visage {
     std::map<void*, WindowX11*> native_window_lookup_;
   };
 
+  class EventLoopWakeup {
+  public:
+    static EventLoopWakeup& instance() {
+      static EventLoopWakeup instance;
+      return instance;
+    }
+
+    static void signal(int fd) {
+      uint64_t value = 1;
+      if (write(fd, &value, sizeof(value)) < 0)
+        return;
+    }
+
+    static void drain(int fd) {
+      uint64_t value = 0;
+      while (read(fd, &value, sizeof(value)) > 0) { }
+    }
+
+    int mainFd() const { return main_fd_; }
+
+    // Wakers only read atomic slots so posting from real-time threads never blocks. Slots live in
+    // blocks that are appended when full and only freed on shutdown. A destroyed fd is closed once
+    // no waker can still be writing to it.
+    int createFd() {
+      int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+      if (fd < 0)
+        return -1;
+
+      SlotBlock* block = &first_block_;
+      while (true) {
+        for (std::atomic<int>& slot : block->fds) {
+          int empty = -1;
+          if (slot.compare_exchange_strong(empty, fd))
+            return fd;
+        }
+
+        SlotBlock* next = block->next.load();
+        if (next == nullptr) {
+          auto added = std::make_unique<SlotBlock>();
+          added->fds[0] = fd;
+          if (block->next.compare_exchange_strong(next, added.get())) {
+            added.release();
+            return fd;
+          }
+        }
+        block = next;
+      }
+    }
+
+    void destroyFd(int fd) {
+      bool removed = false;
+      for (SlotBlock* block = &first_block_; block && !removed; block = block->next.load()) {
+        for (std::atomic<int>& slot : block->fds) {
+          int expected = fd;
+          removed = slot.compare_exchange_strong(expected, -1);
+          if (removed)
+            break;
+        }
+      }
+
+      while (active_wakers_.load() > 0)
+        std::this_thread::yield();
+      close(fd);
+    }
+
+    void wakeAll() {
+      active_wakers_++;
+      for (SlotBlock* block = &first_block_; block; block = block->next.load()) {
+        for (std::atomic<int>& slot : block->fds) {
+          int fd = slot.load();
+          if (fd >= 0)
+            signal(fd);
+        }
+      }
+      active_wakers_--;
+    }
+
+  private:
+    static constexpr int kSlotsPerBlock = 64;
+
+    struct SlotBlock {
+      SlotBlock() {
+        for (std::atomic<int>& slot : fds)
+          slot = -1;
+      }
+
+      std::atomic<int> fds[kSlotsPerBlock];
+      std::atomic<SlotBlock*> next = nullptr;
+    };
+
+    EventLoopWakeup() {
+      main_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+      first_block_.fds[0] = main_fd_;
+    }
+
+    ~EventLoopWakeup() {
+      SlotBlock* block = first_block_.next.load();
+      while (block) {
+        SlotBlock* next = block->next.load();
+        delete block;
+        block = next;
+      }
+      close(main_fd_);
+    }
+
+    SlotBlock first_block_;
+    std::atomic<int> active_wakers_ = 0;
+    int main_fd_ = -1;
+  };
+
   class SharedMessageWindow {
   public:
     static ::Window handle() {
@@ -140,6 +261,10 @@ namespace visage {
     return "";
   }
 
+  void wakeEventLoop() {
+    EventLoopWakeup::instance().wakeAll();
+  }
+
   void setClipboardText(const std::string& text) {
     _clipboard_text = text;
 
@@ -553,27 +678,6 @@ namespace visage {
     NativeWindowLookup::instance().addWindow(this);
   }
 
-  static void threadTimerCallback(WindowX11* window) {
-    while (window->timerThreadRunning()) {
-      Thread::sleep(window->timerMs());
-
-      X11Connection* x11 = window->x11Connection();
-      X11Connection::DisplayLock lock(x11);
-      ::Window window_handle = (::Window)window->nativeHandle();
-
-      XEvent event;
-      memset(&event, 0, sizeof(event));
-      event.type = ClientMessage;
-      event.xclient.window = window_handle;
-      event.xclient.message_type = x11->timerEvent();
-      event.xclient.format = 32;
-      event.xclient.data.l[0] = 0;
-
-      XSendEvent(x11->display(), window_handle, False, NoEventMask, &event);
-      XFlush(x11->display());
-    }
-  }
-
   WindowX11::WindowX11(int width, int height, void* parent_handle) : Window(width, height) {
     static constexpr long kEmbedVersion = 0;
     static constexpr long kEmbedMapped = 1;
@@ -604,9 +708,21 @@ namespace visage {
     XSelectInput(display, window_handle_, kEventMask);
     XFlush(display);
 
-    timer_thread_running_ = true;
-    timer_thread_ = std::make_unique<std::thread>(threadTimerCallback, this);
+    timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    wakeup_fd_ = EventLoopWakeup::instance().createFd();
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    for (int fd : { x11_->fd(), timer_fd_, wakeup_fd_ }) {
+      if (fd < 0)
+        continue;
+
+      epoll_event event {};
+      event.events = EPOLLIN;
+      event.data.fd = fd;
+      epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event);
+    }
+
     start_draw_microseconds_ = time::microseconds();
+    schedulePluginTimer(start_draw_microseconds_);
     setDpiScale(monitor_info_.dpi / kDefaultDpi);
     NativeWindowLookup::instance().addWindow(this);
   }
@@ -614,11 +730,12 @@ namespace visage {
   WindowX11::~WindowX11() {
     NativeWindowLookup::instance().removeWindow(this);
 
-    timer_thread_running_ = false;
-    if (timer_thread_ && timer_thread_->joinable())
-      timer_thread_->join();
-
-    timer_thread_.reset();
+    if (epoll_fd_ >= 0)
+      close(epoll_fd_);
+    if (timer_fd_ >= 0)
+      close(timer_fd_);
+    if (wakeup_fd_ >= 0)
+      EventLoopWakeup::instance().destroyFd(wakeup_fd_);
 
     X11Connection::DisplayLock lock(x11_);
     if (window_handle_)
@@ -1060,28 +1177,57 @@ namespace visage {
   }
 
   void WindowX11::processPluginFdEvents() {
-    bool timer_fired = false;
+    EventLoopWakeup::drain(timer_fd_);
+    EventLoopWakeup::drain(wakeup_fd_);
+
+    bool parent_resized = false;
     XEvent event;
     while (XPending(x11_->display())) {
       XNextEvent(x11_->display(), &event);
 
       if (event.xany.window == parent_handle_ && event.type == ConfigureNotify) {
-        X11Connection::DisplayLock lock(x11_);
-        XWindowAttributes attributes;
-        XGetWindowAttributes(x11_->display(), parent_handle_, &attributes);
-        setNativeWindowSize(attributes.width, attributes.height);
-      }
-      else if (event.xany.window == window_handle_ && event.type == ClientMessage &&
-               event.xclient.message_type == x11_->timerEvent()) {
-        if (!timer_fired) {
-          timer_fired = true;
-          long long microseconds = time::microseconds() - start_draw_microseconds_;
-          drawCallback(microseconds / 1000000.0);
-        }
+        if (parent_resized)
+          coalescer_.countCollapsedConfigure();
+        parent_resized = true;
       }
       else if (event.xany.window == window_handle_ || event.xany.window == parent_handle_)
-        processEvent(event);
+        queueEvent(event);
+    }
+
+    if (parent_resized) {
+      X11Connection::DisplayLock lock(x11_);
+      XWindowAttributes attributes;
+      XGetWindowAttributes(x11_->display(), parent_handle_, &attributes);
+      setNativeWindowSize(attributes.width, attributes.height);
     }
+    flushQueuedEvents();
+
+    long long current_microseconds = time::microseconds();
+    drawIfDue(current_microseconds);
+    schedulePluginTimer(current_microseconds);
+
+    // The round trips above can read new events off the socket into Xlib's queue, and the host
+    // won't poll us again for those
+    if (XEventsQueued(x11_->display(), QueuedAlready))
+      EventLoopWakeup::signal(wakeup_fd_);
+  }
+
+  void WindowX11::schedulePluginTimer(long long current_microseconds) {
+    long long us_until_draw = microsecondsUntilDraw(current_microseconds);
+    itimerspec timer_spec {};
+    if (us_until_draw >= 0) {
+      us_until_draw = std::max(1LL, us_until_draw);
+      timer_spec.it_value.tv_sec = us_until_draw / 1000000;
+      timer_spec.it_value.tv_nsec = (us_until_draw % 1000000) * 1000;
+    }
+    timerfd_settime(timer_fd_, 0, &timer_spec, nullptr);
+  }
+
+  void WindowX11::requestDraw() {
+    if (plugin_x11_)
+      EventLoopWakeup::signal(wakeup_fd_);
+    else
+      EventLoopWakeup::signal(EventLoopWakeup::instance().mainFd());
   }
 
   void WindowX11::processMessageWindowEvent(XEvent& event) {
@@ -1120,6 +1266,109 @@ namespace visage {
     }
   }
 
+  bool X11EventCoalescer::isWheelPress(const XEvent& event) {
+    return event.type == ButtonPress && event.xbutton.button >= 4 && event.xbutton.button <= 7;
+  }
+
+  bool X11EventCoalescer::isWheelRelease(const XEvent& event) {
+    return event.type == ButtonRelease && event.xbutton.button >= 4 && event.xbutton.button <= 7;
+  }
+
+  bool X11EventCoalescer::needsFlush(const XEvent& event) const {
+    if (event.type == MotionNotify)
+      return has_wheel_;
+    if (isWheelPress(event))
+      return has_motion_ || (has_wheel_ && wheel_.xbutton.state != event.xbutton.state);
+    if (isWheelRelease(event) || event.type == ConfigureNotify)
+      return false;
+    return hasQueued();
+  }
+
+  bool X11EventCoalescer::add(const XEvent& event) {
+    if (event.type == MotionNotify) {
+      if (has_motion_)
+        counts_.motion++;
+      motion_ = event;
+      has_motion_ = true;
+      return true;
+    }
+    if (isWheelPress(event)) {
+      if (has_wheel_)
+        counts_.wheel++;
+      int button = event.xbutton.button;
+      wheel_y_ += (button == 4 ? 1.0f : 0.0f) - (button == 5 ? 1.0f : 0.0f);
+      wheel_x_ += (button == 7 ? 1.0f : 0.0f) - (button == 6 ? 1.0f : 0.0f);
+      wheel_ = event;
+      has_wheel_ = true;
+      return true;
+    }
+    if (isWheelRelease(event))
+      return true;
+    if (event.type == ConfigureNotify) {
+      if (has_configure_)
+        counts_.configure++;
+      has_configure_ = true;
+      return true;
+    }
+    return false;
+  }
+
+  bool X11EventCoalescer::takeConfigure() {
+    bool had_configure = has_configure_;
+    has_configure_ = false;
+    return had_configure;
+  }
+
+  bool X11EventCoalescer::takeMotion(XEvent& motion) {
+    if (!has_motion_)
+      return false;
+
+    has_motion_ = false;
+    motion = motion_;
+    return true;
+  }
+
+  bool X11EventCoalescer::takeWheel(XEvent& wheel, float& delta_x, float& delta_y) {
+    if (!has_wheel_)
+      return false;
+
+    has_wheel_ = false;
+    wheel = wheel_;
+    delta_x = wheel_x_;
+    delta_y = wheel_y_;
+    wheel_x_ = 0.0f;
+    wheel_y_ = 0.0f;
+    return true;
+  }
+
+  void WindowX11::queueEvent(XEvent& event) {
+    bool own_event = event.xany.window == window_handle_;
+    if (!own_event || coalescer_.needsFlush(event))
+      flushQueuedEvents();
+    if (!own_event || !coalescer_.add(event))
+      processEvent(event);
+  }
+
+  void WindowX11::flushQueuedEvents() {
+    if (coalescer_.takeConfigure()) {
+      XEvent configure {};
+      configure.type = ConfigureNotify;
+      configure.xany.window = window_handle_;
+      processEvent(configure);
+    }
+
+    XEvent event {};
+    if (coalescer_.takeMotion(event))
+      processEvent(event);
+
+    float delta_x = 0.0f;
+    float delta_y = 0.0f;
+    if (coalescer_.takeWheel(event, delta_x, delta_y)) {
+      handleMouseWheel(delta_x, delta_y, event.xbutton.x, event.xbutton.y, mouseButtonState(),
+                       modifierState());
+    }
+  }
+
   void WindowX11::processEvent(XEvent& event) {
     switch (event.type) {
     case ClientMessage: {
@@ -1420,68 +1669,103 @@ namespace visage {
     case ConfigureNotify: {
       visage::IPoint dimensions = retrieveWindowDimensions();
       handleResized(dimensions.x, dimensions.y);
-      long long us_time = time::microseconds() - start_microseconds_;
-      drawCallback(us_time / 1000000.0);
+      last_draw_microseconds_ = time::microseconds();
+      drawCallback((last_draw_microseconds_ - start_draw_microseconds_) / 1000000.0);
       break;
     }
     }
   }
 
+  long long WindowX11::microsecondsUntilDraw(long long current_microseconds) const {
+    long long ms_until_draw = millisecondsUntilDraw();
+    if (ms_until_draw < 0)
+      return -1;
+
+    long long until_interval = timer_microseconds_ - (current_microseconds - last_draw_microseconds_);
+    return std::max(ms_until_draw * 1000, until_interval);
+  }
+
+  void WindowX11::drawIfDue(long long current_microseconds) {
+    if (microsecondsUntilDraw(current_microseconds) != 0)
+      return;
+
+    last_draw_microseconds_ = current_microseconds;
+    drawCallback((current_microseconds - start_draw_microseconds_) / 1000000.0);
+  }
+
   void WindowX11::runEventLoop() {
+    static constexpr int kNumFds = 2;
     Display* display = x11_->display();
 
-    timeval timeout {};
-    timeout.tv_sec = 0;
-    timeout.tv_usec = 0;
-    fd_set read_fds;
-    unsigned int fd = ConnectionNumber(display);
-
-    start_microseconds_ = time::microseconds();
-    long long last_timer_microseconds = start_microseconds_;
+    pollfd fds[kNumFds] {};
+    fds[0].fd = ConnectionNumber(display);
+    fds[0].events = POLLIN;
+    fds[1].fd = EventLoopWakeup::instance().mainFd();
+    fds[1].events = POLLIN;
 
+    std::vector<::Window> draw_handles;
     XEvent event;
     bool running = true;
     while (running) {
-      FD_ZERO(&read_fds);
-      FD_SET(fd, &read_fds);
-
-      timeout.tv_sec = 0;
-      long long us_to_timer = timer_microseconds_ - (time::microseconds() - last_timer_microseconds);
-      int result = 0;
-      if (us_to_timer > 0) {
-        timeout.tv_usec = us_to_timer;
-        result = select(fd + 1, &read_fds, nullptr, nullptr, &timeout);
+      long long current_microseconds = time::microseconds();
+      long long us_until_draw = -1;
+      for (auto& window : NativeWindowLookup::instance().windows()) {
+        if (window.second->x11_ != x11_ || !window.second->isVisible())
+          continue;
+
+        long long us = window.second->microsecondsUntilDraw(current_microseconds);
+        if (us >= 0 && (us_until_draw < 0 || us < us_until_draw))
+          us_until_draw = us;
       }
-      if (result == -1)
-        running = false;
-      else if (result == 0) {
-        last_timer_microseconds = time::microseconds();
-        long long us_time = last_timer_microseconds - start_microseconds_;
-        drawCallback(us_time / 1000000.0);
+
+      int timeout_ms = us_until_draw < 0 ? -1 : static_cast<int>((us_until_draw + 999) / 1000);
+      if (XPending(display) == 0 && timeout_ms != 0) {
+        if (poll(fds, kNumFds, timeout_ms) < 0 && errno != EINTR)
+          running = false;
       }
-      else if (FD_ISSET(fd, &read_fds)) {
-        while (running && XPending(x11_->display())) {
-          XNextEvent(x11_->display(), &event);
-          WindowX11* window = NativeWindowLookup::instance().findWindow(event.xany.window);
-          if (window == nullptr)
-            continue;
-
-          if (event.type == Expose) {
-            int height = clientHeight();
-            window->handleResized(clientWidth(), height + 1);
-            window->handleResized(clientWidth(), height);
-          }
 
-          if (event.type == DestroyNotify ||
-              (event.type == ClientMessage && event.xclient.data.l[0] == x11_->deleteMessage())) {
-            NativeWindowLookup::instance().removeWindow(window);
-            window->hide();
-            if (!NativeWindowLookup::instance().anyWindowOpen())
-              running = false;
-          }
-          else
-            window->processEvent(event);
+      if (fds[1].revents & POLLIN)
+        EventLoopWakeup::drain(fds[1].fd);
+
+      while (running && XPending(display)) {
+        XNextEvent(display, &event);
+        WindowX11* window = NativeWindowLookup::instance().findWindow(event.xany.window);
+        if (window == nullptr)
+          continue;
+
+        if (event.type == Expose) {
+          int height = clientHeight();
+          window->handleResized(clientWidth(), height + 1);
+          window->handleResized(clientWidth(), height);
+        }
+
+        if (event.type == DestroyNotify ||
+            (event.type == ClientMessage && event.xclient.data.l[0] == x11_->deleteMessage())) {
+          NativeWindowLookup::instance().removeWindow(window);
+          window->hide();
+          if (!NativeWindowLookup::instance().anyWindowOpen())
+            running = false;
         }
+        else
+          window->queueEvent(event);
+      }
+
+      draw_handles.clear();
+      for (auto& window : NativeWindowLookup::instance().windows()) {
+        if (window.second->x11_ == x11_)
+          draw_handles.push_back(window.second->window_handle_);
+      }
+
+      for (::Window handle : draw_handles) {
+        if (WindowX11* window = NativeWindowLookup::instance().findWindow(handle))
+          window->flushQueuedEvents();
+      }
+
+      current_microseconds = time::microseconds();
+      for (::Window handle : draw_handles) {
+        WindowX11* window = NativeWindowLookup::instance().findWindow(handle);
+        if (window && window->isVisible())
+          window->drawIfDue(current_microseconds);
       }
     }
   }
@@ -25,9 +25,7 @@
 #include "visage_utils/string_utils.h"
 #include "windowing.h"
 
-#include <atomic>
 #include <map>
-#include <thread>
 #include <X11/Xatom.h>
 #include <X11/Xlib.h>
 
@@ -97,7 +95,6 @@ namespace visage {
       clipboard_ = XInternAtom(display_, "CLIPBOARD", False);
       utf8_string_ = XInternAtom(display_, "UTF8_STRING", False);
       targets_ = XInternAtom(display_, "TARGETS", False);
-      timer_event_ = XInternAtom(display_, "VISAGE_TIMER_EVENT", False);
       delete_message_ = XInternAtom(display_, "WM_DELETE_WINDOW", False);
       dnd_aware_ = XInternAtom(display_, "XdndAware", False);
       dnd_proxy_ = XInternAtom(display_, "XdndProxy", False);
@@ -129,7 +126,6 @@ namespace visage {
     Atom clipboard() const { return clipboard_; }
     Atom utf8String() const { return utf8_string_; }
     Atom targets() const { return targets_; }
-    Atom timerEvent() const { return timer_event_; }
     Atom* deleteMessageRef() { return &delete_message_; }
     Atom deleteMessage() const { return delete_message_; }
     Atom dndAware() const { return dnd_aware_; }
@@ -162,7 +158,6 @@ namespace visage {
     Atom clipboard_ = 0;
     Atom utf8_string_ = 0;
     Atom targets_ = 0;
-    Atom timer_event_ = 0;
     Atom delete_message_ = 0;
     Atom dnd_aware_ = 0;
     Atom dnd_proxy_ = 0;
@@ -193,6 +188,41 @@ namespace visage {
     float dpi = Window::kDefaultDpi;
   };
 
+  // Holds back motion, wheel and configure events from one batch so only the latest motion, the
+  // summed wheel delta and a single resize reach the window.
+  class X11EventCoalescer {
+  public:
+    struct Counts {
+      long long motion = 0;
+      long long wheel = 0;
+      long long configure = 0;
+    };
+
+    static bool isWheelPress(const XEvent& event);
+    static bool isWheelRelease(const XEvent& event);
+
+    bool needsFlush(const XEvent& event) const;
+    bool add(const XEvent& event);
+
+    bool takeConfigure();
+    bool takeMotion(XEvent& motion);
+    bool takeWheel(XEvent& wheel, float& delta_x, float& delta_y);
+
+    void countCollapsedConfigure() { counts_.configure++; }
+    bool hasQueued() const { return has_motion_ || has_wheel_ || has_configure_; }
+    const Counts& counts() const { return counts_; }
+
+  private:
+    XEvent motion_ {};
+    XEvent wheel_ {};
+    bool has_motion_ = false;
+    bool has_wheel_ = false;
+    bool has_configure_ = false;
+    float wheel_x_ = 0.0f;
+    float wheel_y_ = 0.0f;
+    Counts counts_;
+  };
+
   class WindowX11 : public Window {
   public:
     static constexpr long kEventMask = ExposureMask | KeyPressMask | KeyReleaseMask |
@@ -216,6 +246,9 @@ namespace visage {
     void processPluginFdEvents() override;
     void processMessageWindowEvent(XEvent& event);
     void processEvent(XEvent& event);
+    void queueEvent(XEvent& event);
+    void flushQueuedEvents();
+    const X11EventCoalescer::Counts& coalescedEventCounts() const { return coalescer_.counts(); }
 
     void* nativeHandle() const override { return (void*)window_handle_; }
 
@@ -223,7 +256,9 @@ namespace visage {
     void removeWindowDecorationButtons();
     void* initWindow() const override;
     void* globalDisplay() const override { return X11Connection::globalInstance()->display(); }
-    int posixFd() const override { return x11_->fd(); }
+    int posixFd() const override { return plugin_x11_ ? epoll_fd_ : x11_->fd(); }
+    int timerFd() const { return timer_fd_; }
+    int wakeupFd() const { return wakeup_fd_; }
 
     void setFixedAspectRatio(bool fixed) override;
 
@@ -238,8 +273,9 @@ namespace visage {
     IPoint minWindowDimensions() const override;
     MonitorInfo monitorInfo() { return monitor_info_; }
     X11Connection* x11Connection() { return x11_; }
-    bool timerThreadRunning() { return timer_thread_running_.load(); }
-    int timerMs() const { return timer_microseconds_.load() / 1000; }
+    long long microsecondsUntilDraw(long long current_microseconds) const;
+    void drawIfDue(long long current_microseconds);
+    void requestDraw() override;
 
   private:
     static WindowX11* last_active_window_;
@@ -254,6 +290,7 @@ namespace visage {
     void createWindow(IBounds bounds);
     IPoint retrieveWindowDimensions();
     void passEventToParent(XEvent& event);
+    void schedulePluginTimer(long long current_microseconds);
     int mouseButtonState() const;
     int modifierState() const;
 
@@ -286,10 +323,13 @@ namespace visage {
     ::Window window_handle_ = 0;
     ::Window parent_handle_ = 0;
     std::map<KeySym, bool> pressed_;
-    long long start_microseconds_ = 0;
-    std::atomic<long long> timer_microseconds_ = 16667;
-    std::atomic<bool> timer_thread_running_ = false;
-    std::unique_ptr<std::thread> timer_thread_;
+    long long last_draw_microseconds_ = 0;
+    X11EventCoalescer coalescer_;
+
+    long long timer_microseconds_ = 16667;
+    int epoll_fd_ = -1;
+    int timer_fd_ = -1;
+    int wakeup_fd_ = -1;
   };
 }
 
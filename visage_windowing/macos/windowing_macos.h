@@ -38,6 +38,8 @@ namespace visage {
 @interface VisageAppViewDelegate : NSObject <MTKViewDelegate>
 @property(nonatomic) visage::WindowMac* visage_window;
 @property long long start_microseconds;
+
+- (void)drawWindow;
 @end
 
 @interface VisageAppView : MTKView <NSDraggingDestination>
@@ -90,6 +92,7 @@ namespace visage {
     IPoint minWindowDimensions() const override;
 
     void handleNativeResize(int width, int height);
+    void drawWindow();
     bool isPopup() const { return decoration_ == Decoration::Popup; }
 
   private:
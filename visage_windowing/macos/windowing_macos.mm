@@ -56,6 +56,10 @@ namespace visage {
       return it != native_window_lookup_.end() ? it->second : nullptr;
     }
 
+    WindowMac* anyWindow() {
+      return native_window_lookup_.empty() ? nullptr : native_window_lookup_.begin()->second;
+    }
+
   private:
     NativeWindowLookup() = default;
     ~NativeWindowLookup() = default;
@@ -96,6 +100,13 @@ namespace visage {
     [pasteboard setString:ns_text forType:NSPasteboardTypeString];
   }
 
+  void wakeEventLoop() {
+    dispatch_async(dispatch_get_main_queue(), ^{
+      if (WindowMac* window = NativeWindowLookup::instance().anyWindow())
+        window->drawWindow();
+    });
+  }
+
   void setCursorStyle(MouseCursor style) {
     static const NSCursor* arrow_cursor = [NSCursor arrowCursor];
     static const NSCursor* ibeam_cursor = [NSCursor IBeamCursor];
@@ -742,6 +753,10 @@ namespace visage {
     }
   }
 
+  void WindowMac::drawWindow() {
+    [view_delegate_ drawWindow];
+  }
+
   void* WindowMac::initWindow() const {
     return (__bridge void*)InitialMetalLayer::layer();
   }
@@ -0,0 +1,118 @@
+/* Copyright Vital Audio, LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#if VISAGE_LINUX
+#include "visage_windowing/linux/windowing_x11.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace visage;
+
+static XEvent wheelEvent(int type, unsigned int button, unsigned int state = 0) {
+  XEvent event {};
+  event.type = type;
+  event.xbutton.button = button;
+  event.xbutton.state = state;
+  event.xbutton.x = 10;
+  event.xbutton.y = 20;
+  return event;
+}
+
+TEST_CASE("Wheel press and release pairs coalesce", "[windowing]") {
+  X11EventCoalescer coalescer;
+  for (int i = 0; i < 3; ++i) {
+    for (int type : { ButtonPress, ButtonRelease }) {
+      XEvent event = wheelEvent(type, 4);
+      REQUIRE_FALSE(coalescer.needsFlush(event));
+      REQUIRE(coalescer.add(event));
+    }
+  }
+  for (int type : { ButtonPress, ButtonRelease }) {
+    XEvent event = wheelEvent(type, 6);
+    REQUIRE_FALSE(coalescer.needsFlush(event));
+    REQUIRE(coalescer.add(event));
+  }
+
+  REQUIRE(coalescer.counts().wheel == 3);
+
+  XEvent wheel {};
+  float delta_x = 0.0f;
+  float delta_y = 0.0f;
+  REQUIRE(coalescer.takeWheel(wheel, delta_x, delta_y));
+  REQUIRE(delta_x == -1.0f);
+  REQUIRE(delta_y == 3.0f);
+  REQUIRE(wheel.xbutton.x == 10);
+  REQUIRE(wheel.xbutton.y == 20);
+  REQUIRE_FALSE(coalescer.hasQueued());
+  REQUIRE_FALSE(coalescer.takeWheel(wheel, delta_x, delta_y));
+}
+
+TEST_CASE("Wheel coalescing flushes on modifier change", "[windowing]") {
+  X11EventCoalescer coalescer;
+  coalescer.add(wheelEvent(ButtonPress, 5));
+  coalescer.add(wheelEvent(ButtonRelease, 5));
+
+  XEvent shifted = wheelEvent(ButtonPress, 5, ShiftMask);
+  REQUIRE(coalescer.needsFlush(shifted));
+
+  XEvent wheel {};
+  float delta_x = 0.0f;
+  float delta_y = 0.0f;
+  REQUIRE(coalescer.takeWheel(wheel, delta_x, delta_y));
+  REQUIRE(delta_y == -1.0f);
+
+  coalescer.add(shifted);
+  REQUIRE(coalescer.takeWheel(wheel, delta_x, delta_y));
+  REQUIRE(delta_y == -1.0f);
+  REQUIRE(wheel.xbutton.state == ShiftMask);
+  REQUIRE(coalescer.counts().wheel == 0);
+}
+
+TEST_CASE("Motion and configure events coalesce", "[windowing]") {
+  X11EventCoalescer coalescer;
+  for (int i = 0; i < 4; ++i) {
+    XEvent motion {};
+    motion.type = MotionNotify;
+    motion.xmotion.x = i;
+    REQUIRE_FALSE(coalescer.needsFlush(motion));
+    REQUIRE(coalescer.add(motion));
+
+    XEvent configure {};
+    configure.type = ConfigureNotify;
+    REQUIRE(coalescer.add(configure));
+  }
+
+  REQUIRE(coalescer.counts().motion == 3);
+  REQUIRE(coalescer.counts().configure == 3);
+
+  XEvent key {};
+  key.type = KeyPress;
+  REQUIRE(coalescer.needsFlush(key));
+  REQUIRE_FALSE(coalescer.add(key));
+
+  REQUIRE(coalescer.takeConfigure());
+  XEvent motion {};
+  REQUIRE(coalescer.takeMotion(motion));
+  REQUIRE(motion.xmotion.x == 3);
+  REQUIRE_FALSE(coalescer.hasQueued());
+  REQUIRE_FALSE(coalescer.needsFlush(key));
+}
+#endif
@@ -38,6 +38,7 @@
 #include "visage_utils/thread_utils.h"
 
 #include <algorithm>
+#include <atomic>
 #include <dxgi1_4.h>
 #include <map>
 #include <ShlObj.h>
@@ -45,6 +46,7 @@
 #include <windowsx.h>
 
 #define WM_VBLANK (WM_USER + 1)
+#define WM_WAKE_EVENT_LOOP (WM_USER + 2)
 
 typedef DPI_AWARENESS_CONTEXT(WINAPI* GetWindowDpiAwarenessContext_t)(HWND);
 typedef DPI_AWARENESS_CONTEXT(WINAPI* GetThreadDpiAwarenessContext_t)();
@@ -70,6 +72,8 @@ namespace visage {
       native_window_lookup_[window->nativeHandle()] = window;
       if (window->parentHandle())
         parent_window_lookup_[window->parentHandle()] = window;
+      if (wake_window_.load() == nullptr)
+        wake_window_ = window->windowHandle();
     }
 
     void removeWindow(WindowWin32* window) {
@@ -77,8 +81,16 @@ namespace visage {
         parent_window_lookup_.erase(window->parentHandle());
       if (native_window_lookup_.count(window->nativeHandle()))
         native_window_lookup_.erase(window->nativeHandle());
+
+      if (wake_window_.load() == window->windowHandle()) {
+        auto next = native_window_lookup_.begin();
+        wake_window_ = next == native_window_lookup_.end() ? nullptr : next->second->windowHandle();
+      }
     }
 
+    // Read from any thread. Posting to a window that was just destroyed fails harmlessly.
+    HWND wakeWindow() const { return wake_window_.load(); }
+
     bool anyWindowOpen() const {
       for (auto& window : native_window_lookup_) {
         if (window.second->isShowing())
@@ -111,6 +123,7 @@ namespace visage {
 
     std::map<void*, WindowWin32*> parent_window_lookup_;
     std::map<void*, WindowWin32*> native_window_lookup_;
+    std::atomic<HWND> wake_window_ = nullptr;
   };
 
   std::string readClipboardText() {
@@ -157,6 +170,11 @@ namespace visage {
     CloseClipboard();
   }
 
+  void wakeEventLoop() {
+    if (HWND hwnd = NativeWindowLookup::instance().wakeWindow())
+      PostMessage(hwnd, WM_WAKE_EVENT_LOOP, 0, 0);
+  }
+
   void setCursorStyle(MouseCursor style) {
     static const HCURSOR arrow_cursor = LoadCursor(nullptr, IDC_ARROW);
     static const HCURSOR ibeam_cursor = LoadCursor(nullptr, IDC_IBEAM);
@@ -1002,6 +1020,11 @@ namespace visage {
       drawCallback(v_blank_thread_->vBlankTime());
       return 0;
     }
+    case WM_WAKE_EVENT_LOOP: {
+      if (v_blank_thread_)
+        drawCallback(v_blank_thread_->vBlankTime());
+      return 0;
+    }
     case WM_SYSKEYDOWN:
     case WM_KEYDOWN: {
       KeyCode key_code = keyCodeFromScanCode(w_param, l_param);
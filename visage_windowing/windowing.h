@@ -103,6 +103,7 @@ namespace visage {
     virtual void* globalDisplay() const { return nullptr; }
     virtual void processPluginFdEvents() { }
     virtual int posixFd() const { return 0; }
+    virtual void requestDraw() { }
 
     virtual void show() = 0;
     virtual void showMaximized() = 0;
@@ -124,6 +125,21 @@ namespace visage {
         draw_callback_(time);
     }
 
+    // Returns milliseconds until the window needs drawing, 0 when it's due now and -1 when
+    // nothing is scheduled. Without a deadline callback or with idle mode off, always 0.
+    void setDrawDeadlineCallback(std::function<long long()> callback) {
+      draw_deadline_callback_ = std::move(callback);
+    }
+
+    long long millisecondsUntilDraw() const {
+      if (!idle_mode_ || draw_deadline_callback_ == nullptr)
+        return 0;
+      return draw_deadline_callback_();
+    }
+
+    void setIdleMode(bool idle_mode) { idle_mode_ = idle_mode; }
+    bool idleMode() const { return idle_mode_; }
+
     void setMinimumWindowScale(float scale) { min_window_scale_ = scale; }
     float minimumWindowScale() const { return min_window_scale_; }
     virtual void setFixedAspectRatio(bool fixed) { fixed_aspect_ratio_ = fixed; }
@@ -200,12 +216,14 @@ namespace visage {
     RepeatClick mouse_repeat_clicks_;
 
     std::function<void(double)> draw_callback_ = nullptr;
+    std::function<long long()> draw_deadline_callback_ = nullptr;
     CallbackList<void()> on_show_;
     CallbackList<void()> on_hide_;
     CallbackList<void()> on_contents_resized_;
     float dpi_scale_ = 1.0f;
     float min_window_scale_ = kDefaultMinWindowScale;
     bool visible_ = true;
+    bool idle_mode_ = true;
     bool fixed_aspect_ratio_ = false;
     bool mouse_relative_mode_ = false;
     float aspect_ratio_ = 1.0f;
@@ -224,6 +242,10 @@ namespace visage {
   void showMessageBox(std::string title, std::string message);
   std::string readClipboardText();
   void setClipboardText(const std::string& text);
+  // Safe to call from any thread. Makes the event loop run a draw callback soon so posted work
+  // doesn't wait for the next timer. On Emscripten this does nothing and posted work runs on the
+  // next animation frame.
+  void wakeEventLoop();
 
   int doubleClickSpeed();
   void setDoubleClickSpeed(int ms);